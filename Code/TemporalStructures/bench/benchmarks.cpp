@@ -0,0 +1,255 @@
+#include <benchmark/benchmark.h>
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include "generators.h"
+#include "queryWorkspace.h"
+#include "windowAlgorithms.h"
+
+using namespace std;
+
+#ifndef TEMPORAL_BENCH_MAX_CONTACTS
+#define TEMPORAL_BENCH_MAX_CONTACTS 10000000
+#endif
+
+// Famiglie di grafi generati: il secondo argomento di ogni benchmark
+enum Family
+{
+    Random,
+    Preferential,
+    Transit,
+    Hypercube,
+    AxiotisFotakis,
+};
+
+const char *FAMILY_NAMES[] = {"random", "preferential", "transit", "hypercube", "axiotisFotakis"};
+
+// grafo della famiglia con circa contacts contatti
+GeneratedGraph generate(Family family, int64_t contacts)
+{
+    uint32_t vertices = uint32_t(max<int64_t>(16, contacts / 8));
+    int lifetime = int(min<int64_t>(contacts, 1 << 30));
+    switch (family)
+    {
+    case Random:
+        return randomTemporalGraph(vertices, size_t(contacts), lifetime, 1);
+    case Preferential:
+        // 4 archi per vertice con 2 contatti ciascuno
+        return preferentialAttachment(vertices, 4, 2, lifetime, 2);
+    case Transit:
+    {
+        // linee di 16 fermate con una corsa ogni 60 unita' di tempo
+        uint32_t stations = uint32_t(max<int64_t>(32, contacts / 100));
+        uint32_t lines = stations / 4;
+        int horizon = int(contacts * 60 / (int64_t(lines) * 15)) + 16;
+        return periodicSchedule(stations, lines, 16, 60, horizon, 3);
+    }
+    case Hypercube:
+    {
+        // dimension * 2^(dimension - 1) archi
+        uint32_t dimension = 2;
+        while ((int64_t(dimension + 1) << dimension) <= contacts)
+        {
+            dimension++;
+        }
+        return kempeHypercube(dimension);
+    }
+    case AxiotisFotakis:
+    {
+        // n (n + 9) / 2 - 3 archi, con n pari
+        uint32_t n = uint32_t(sqrt(2.0 * contacts)) & ~uint32_t(1);
+        return axiotisFotakis(max<uint32_t>(n, 4));
+    }
+    }
+    return {};
+}
+
+// memoria residente attuale del processo in MiB (seconda colonna di /proc/self/statm)
+double residentMB()
+{
+    FILE *statm = fopen("/proc/self/statm", "r");
+    long pages = 0;
+    if (statm != nullptr)
+    {
+        if (fscanf(statm, "%*ld %ld", &pages) != 1)
+        {
+            pages = 0;
+        }
+        fclose(statm);
+    }
+    return double(pages) * double(sysconf(_SC_PAGESIZE)) / (1024.0 * 1024.0);
+}
+
+// memoria residente subito dopo la generazione del grafo in cache
+double graphResidentMB = 0;
+
+// Si conserva solo l'ultimo grafo generato: i benchmark chiedono la stessa famiglia e
+// dimensione per tutte le ripetizioni di una misura, e il grafo precedente viene liberato
+// al cambio, cosi' la memoria residente dipende solo dal grafo in uso
+TemporalGraph &cachedGraph(Family family, int64_t contacts)
+{
+    static pair<int, int64_t> cachedKey;
+    static unique_ptr<TemporalGraph> cached;
+    // i benchmark concorrenti chiedono il grafo da piu' thread
+    static mutex cacheMutex;
+    lock_guard<mutex> lock(cacheMutex);
+    if (!cached || cachedKey != make_pair(int(family), contacts))
+    {
+        cached.reset();
+        cached = make_unique<TemporalGraph>(generatedStorage(generate(family, contacts)));
+        cachedKey = {family, contacts};
+        graphResidentMB = residentMB();
+    }
+    return *cached;
+}
+
+// Prepara il grafo fuori dalla misura e riporta il throughput e la memoria residente
+// acquisita dalle query sul grafo, in tutte le ripetizioni della misura (queryRSS_MB,
+// escluso il grafo: le ripetizioni successive alla prima riusano i buffer gia' allocati,
+// quindi non basta guardare l'ultima). Con perContact gli item
+// sono i contatti del grafo, per le query che li scorrono tutti; altrimenti sono le query.
+template <typename Body>
+void runOnGraph(benchmark::State &state, Body body, bool perContact = true)
+{
+    Family family = Family(state.range(1));
+    TemporalGraph &g = cachedGraph(family, state.range(0));
+    state.SetLabel(FAMILY_NAMES[family]);
+
+    for (auto _ : state)
+    {
+        body(g);
+    }
+
+    int64_t items = perContact ? int64_t(g.storage.contacts.size()) : 1;
+    state.SetItemsProcessed(int64_t(state.iterations()) * items);
+    state.counters["contacts"] = double(g.storage.contacts.size());
+    state.counters["queryRSS_MB"] = max(0.0, residentMB() - graphResidentMB);
+}
+
+void edgeStreamBench(benchmark::State &state)
+{
+    runOnGraph(state, [](TemporalGraph &g)
+               { benchmark::DoNotOptimize(g.edgeStream("0", false)); });
+}
+
+void earliestTimeBench(benchmark::State &state)
+{
+    runOnGraph(state, [](TemporalGraph &g)
+               { benchmark::DoNotOptimize(g.earliestTime("0")); });
+}
+
+void latestDepartureBench(benchmark::State &state)
+{
+    runOnGraph(state, [](TemporalGraph &g)
+               { benchmark::DoNotOptimize(g.latestDeparture("0")); });
+}
+
+void earliestTimeTreeBench(benchmark::State &state)
+{
+    runOnGraph(state, [](TemporalGraph &g)
+               { benchmark::DoNotOptimize(g.earliestTimeTree("0")); });
+}
+
+void latestDepartureTreeBench(benchmark::State &state)
+{
+    runOnGraph(state, [](TemporalGraph &g)
+               { benchmark::DoNotOptimize(g.latestDepartureTree("0")); });
+}
+
+void windowAlgorithmEaBench(benchmark::State &state)
+{
+    WindowResult result;
+    runOnGraph(state, [&result](TemporalGraph &g)
+               {
+                   windowAlgorithmEa(g, "0", result);
+                   benchmark::DoNotOptimize(result.entries.data());
+               });
+}
+
+void windowAlgorithmLdBench(benchmark::State &state)
+{
+    WindowResult result;
+    runOnGraph(state, [&result](TemporalGraph &g)
+               {
+                   windowAlgorithmLd(g, "0", result);
+                   benchmark::DoNotOptimize(result.entries.data());
+               });
+}
+
+// Query punto a punto da "0" verso destinazioni diverse: ogni query legge solo una parte
+// dei contatti, quindi items_per_second conta le query e non i contatti
+void pointToPointBench(benchmark::State &state)
+{
+    uint32_t target = 0;
+    runOnGraph(state, [&target](TemporalGraph &g)
+               {
+                   target = (target + 7919) % g.storage.vertexCount();
+                   benchmark::DoNotOptimize(g.earliestArrival("0", to_string(target), 0));
+               },
+               false);
+}
+
+// Query concorrenti sullo stesso grafo condiviso, senza lock: ogni thread usa la propria
+// workspace e parte da sorgenti diverse. Con UseRealTime items_per_second e' il
+// throughput complessivo, da confrontare al variare del numero di thread.
+void concurrentEarliestTimeBench(benchmark::State &state)
+{
+    const TemporalGraph &g = cachedGraph(Family(state.range(1)), state.range(0));
+    QueryWorkspace &workspace = threadWorkspace();
+    uint32_t source = uint32_t(state.thread_index()) * 7919;
+    for (auto _ : state)
+    {
+        source = (source + 1) % g.storage.vertexCount();
+        benchmark::DoNotOptimize(g.earliestTime(to_string(source), workspace).data());
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(g.storage.contacts.size()));
+}
+
+void concurrentSizes(benchmark::internal::Benchmark *bench)
+{
+    bench->ArgNames({"contacts", "family"});
+    for (int64_t contacts = 10000; contacts <= min<int64_t>(1000000, TEMPORAL_BENCH_MAX_CONTACTS); contacts *= 10)
+    {
+        bench->Args({contacts, Random});
+    }
+    for (int threads = 1; threads <= int(thread::hardware_concurrency()); threads *= 2)
+    {
+        bench->Threads(threads);
+    }
+    bench->UseRealTime()->Unit(benchmark::kMillisecond);
+}
+
+// dimensioni da 10^4 a TEMPORAL_BENCH_MAX_CONTACTS contatti per ogni famiglia
+void sizes(benchmark::internal::Benchmark *bench)
+{
+    bench->ArgNames({"contacts", "family"});
+    for (int family = Random; family <= AxiotisFotakis; family++)
+    {
+        for (int64_t contacts = 10000; contacts <= int64_t(TEMPORAL_BENCH_MAX_CONTACTS); contacts *= 10)
+        {
+            bench->Args({contacts, family});
+        }
+    }
+    bench->Unit(benchmark::kMillisecond);
+}
+
+BENCHMARK(edgeStreamBench)->Apply(sizes);
+BENCHMARK(earliestTimeBench)->Apply(sizes);
+BENCHMARK(latestDepartureBench)->Apply(sizes);
+BENCHMARK(earliestTimeTreeBench)->Apply(sizes);
+BENCHMARK(latestDepartureTreeBench)->Apply(sizes);
+BENCHMARK(windowAlgorithmEaBench)->Apply(sizes);
+BENCHMARK(windowAlgorithmLdBench)->Apply(sizes);
+BENCHMARK(pointToPointBench)->Apply(sizes);
+BENCHMARK(concurrentEarliestTimeBench)->Apply(concurrentSizes);
+
+BENCHMARK_MAIN();
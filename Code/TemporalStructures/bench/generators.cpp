@@ -0,0 +1,194 @@
+#include "generators.h"
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <string>
+
+using namespace std;
+
+TemporalStorage generatedStorage(const GeneratedGraph &graph)
+{
+    TemporalStorage storage(graph.directed);
+    for (uint32_t v = 0; v < graph.vertexCount; v++)
+    {
+        storage.names.intern(to_string(v));
+    }
+    storage.build(graph.contacts);
+    return storage;
+}
+
+GeneratedGraph randomTemporalGraph(uint32_t vertexCount, size_t contactCount, int lifetime, uint64_t seed,
+                                   bool directed)
+{
+    GeneratedGraph graph;
+    graph.vertexCount = vertexCount;
+    graph.directed = directed;
+    graph.contacts.reserve(contactCount);
+
+    mt19937_64 random(seed);
+    uniform_int_distribution<uint32_t> vertex(0, vertexCount - 1);
+    uniform_int_distribution<int> time(0, lifetime - 1);
+    while (graph.contacts.size() < contactCount)
+    {
+        uint32_t from = vertex(random);
+        uint32_t to = vertex(random);
+        if (from != to)
+        {
+            graph.contacts.push_back({from, to, time(random)});
+        }
+    }
+    return graph;
+}
+
+GeneratedGraph preferentialAttachment(uint32_t vertexCount, uint32_t edgesPerVertex, uint32_t contactsPerEdge,
+                                      int lifetime, uint64_t seed)
+{
+    GeneratedGraph graph;
+    graph.vertexCount = vertexCount;
+    mt19937_64 random(seed);
+
+    // ogni arco inserisce i suoi estremi: un'estrazione uniforme e' proporzionale al grado
+    vector<uint32_t> endpoints;
+    vector<uint32_t> chosen;
+    for (uint32_t v = 1; v < vertexCount; v++)
+    {
+        int arrival = int(int64_t(v) * lifetime / vertexCount);
+        uniform_int_distribution<int> time(arrival, lifetime - 1);
+
+        chosen.clear();
+        uint32_t wanted = min(edgesPerVertex, v);
+        for (uint32_t attempt = 0; chosen.size() < wanted && attempt < 4 * wanted; attempt++)
+        {
+            uint32_t target = endpoints.empty() ? uint32_t(random() % v) : endpoints[random() % endpoints.size()];
+            if (find(chosen.begin(), chosen.end(), target) == chosen.end())
+            {
+                chosen.push_back(target);
+            }
+        }
+        for (uint32_t target : chosen)
+        {
+            for (uint32_t c = 0; c < contactsPerEdge; c++)
+            {
+                graph.contacts.push_back({v, target, time(random)});
+            }
+            endpoints.push_back(v);
+            endpoints.push_back(target);
+        }
+    }
+    return graph;
+}
+
+GeneratedGraph periodicSchedule(uint32_t stations, uint32_t lines, uint32_t stopsPerLine, int period, int horizon,
+                                uint64_t seed)
+{
+    GeneratedGraph graph;
+    graph.vertexCount = stations;
+    graph.directed = true;
+    mt19937_64 random(seed);
+
+    vector<uint32_t> stops(stations);
+    iota(stops.begin(), stops.end(), 0);
+    stopsPerLine = min(stopsPerLine, stations);
+    for (uint32_t line = 0; line < lines; line++)
+    {
+        // fermate distinte: prefisso di una permutazione casuale
+        for (uint32_t k = 0; k < stopsPerLine; k++)
+        {
+            swap(stops[k], stops[k + random() % (stations - k)]);
+        }
+        for (int64_t departure = random() % period; departure + stopsPerLine - 1 < horizon; departure += period)
+        {
+            for (uint32_t k = 0; k + 1 < stopsPerLine; k++)
+            {
+                graph.contacts.push_back({stops[k], stops[k + 1], int(departure + k)});
+            }
+        }
+    }
+    return graph;
+}
+
+GeneratedGraph kempeHypercube(uint32_t dimension)
+{
+    GeneratedGraph graph;
+    graph.vertexCount = uint32_t(1) << dimension;
+    for (uint32_t v = 0; v < graph.vertexCount; v++)
+    {
+        for (uint32_t i = 0; i < dimension; i++)
+        {
+            uint32_t neighbour = v ^ (uint32_t(1) << i);
+            if (v < neighbour)
+            {
+                graph.contacts.push_back({v, neighbour, int(i)});
+            }
+        }
+    }
+    return graph;
+}
+
+GeneratedGraph axiotisFotakis(uint32_t n)
+{
+    GeneratedGraph graph;
+    graph.vertexCount = 3 * n;
+    int scale = 8 * n;
+    int half = n / 2;
+    // a_k, h_k, c_k con k da 1 a n
+    auto a = [](uint32_t k)
+    { return k - 1; };
+    auto h = [n](uint32_t k)
+    { return n + k - 1; };
+    auto c = [n](uint32_t k)
+    { return 2 * n + k - 1; };
+    auto add = [&graph](uint32_t from, uint32_t to, int time)
+    {
+        graph.contacts.push_back({from, to, time});
+    };
+
+    // parte densa: K_n su A divisa negli n/2 cammini hamiltoniani di Walecki j, j+1, j-1, j+2, ...
+    // tutti gli archi del cammino p_i hanno etichetta i e i suoi estremi portano a h_{2i-1} e h_{2i}
+    for (int i = 1; i <= half; i++)
+    {
+        uint32_t j = i - 1;
+        uint32_t previous = j;
+        for (uint32_t k = 1; k < n; k++)
+        {
+            uint32_t next = k % 2 == 1 ? (j + (k + 1) / 2) % n : (j + n - k / 2) % n;
+            add(a(previous + 1), a(next + 1), i * scale);
+            previous = next;
+        }
+        add(a(j + 1), h(2 * i - 1), i * scale);
+        add(a(previous + 1), h(2 * i), i * scale);
+    }
+
+    // c_{2i-1} entra in h_{2i-1}, h_{2i} con etichette grandi, c_{2i} ne esce con etichette piccolissime
+    for (int i = 1; i <= half; i++)
+    {
+        add(c(2 * i - 1), h(2 * i - 1), (half + 2 * i - 1) * scale);
+        add(c(2 * i - 1), h(2 * i), (half + 2 * i) * scale);
+        add(c(2 * i), h(2 * i - 1), half + 2 * i - 1);
+        add(c(2 * i), h(2 * i), half + 2 * i);
+    }
+
+    // archi tra i vertici di C, in ordine decrescente dell'estremo maggiore e crescente del
+    // minore: il k-esimo ha etichetta 1 - (k - 1) epsilon
+    vector<pair<uint32_t, uint32_t>> order;
+    for (uint32_t k = 1; k + 3 <= n; k += 2)
+    {
+        order.push_back({k, n});
+    }
+    for (uint32_t high = n - 2; high >= 4; high -= 2)
+    {
+        order.push_back({high - 3, high});
+    }
+    for (size_t k = 0; k < order.size(); k++)
+    {
+        add(c(order[k].first), c(order[k].second), scale - int(k));
+    }
+
+    for (int i = 1; i <= half; i++)
+    {
+        add(c(2 * i - 1), a(2 * i - 1), 1);
+        add(c(2 * i), a(2 * i), (int(n) + 1) * scale);
+    }
+    return graph;
+}
@@ -0,0 +1,49 @@
+#ifndef GENERATORS_H
+#define GENERATORS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "temporalStructures.h"
+
+using namespace std;
+
+// Grafo generato: vertici 0 .. vertexCount - 1 e contatti (non ordinati)
+struct GeneratedGraph
+{
+    uint32_t vertexCount = 0;
+    vector<Contact> contacts;
+    bool directed = false;
+};
+
+// Storage con i vertici chiamati "0", "1", ... e i contatti generati
+TemporalStorage generatedStorage(const GeneratedGraph &graph);
+
+// contactCount contatti tra coppie di vertici distinti uniformi, con tempi uniformi in [0, lifetime)
+GeneratedGraph randomTemporalGraph(uint32_t vertexCount, size_t contactCount, int lifetime, uint64_t seed,
+                                   bool directed = false);
+
+// Attaccamento preferenziale temporale: il vertice v arriva al tempo v * lifetime / vertexCount
+// e si collega a edgesPerVertex vertici gia' presenti scelti con probabilita' proporzionale al
+// grado; ogni arco ha contactsPerEdge contatti uniformi tra l'arrivo di v e lifetime.
+GeneratedGraph preferentialAttachment(uint32_t vertexCount, uint32_t edgesPerVertex, uint32_t contactsPerEdge,
+                                      int lifetime, uint64_t seed);
+
+// Orario periodico stile trasporto pubblico (orientato): ogni linea visita stopsPerLine
+// fermate casuali tra stations; una corsa parte dal capolinea ogni period unita' di tempo
+// fino a horizon e impiega una unita' di tempo per tratta.
+GeneratedGraph periodicSchedule(uint32_t stations, uint32_t lines, uint32_t stopsPerLine, int period, int horizon,
+                                uint64_t seed);
+
+// Ipercubo di dimensione dimension con l'etichetta i sugli archi della dimensione i
+// (Kempe, Kleinberg, Kumar): temporalmente connesso e minimo, con n log n archi.
+GeneratedGraph kempeHypercube(uint32_t dimension);
+
+// Costruzione di Axiotis e Fotakis (Teorema 1) per n pari: 3n vertici, n(n+9)/2 - 3 archi con
+// un contatto ciascuno, temporalmente connessa in modalita' non stretta e tale che rimuovendo
+// un qualsiasi arco della parte densa (la clique su A) la connettivita' si perde. Le etichette
+// frazionarie del lavoro originale sono scalate di un fattore 8n, cosi' epsilon vale 1.
+GeneratedGraph axiotisFotakis(uint32_t n);
+
+#endif
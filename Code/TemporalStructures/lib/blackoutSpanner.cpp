@@ -0,0 +1,454 @@
+#include "blackoutSpanner.h"
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+
+using namespace std;
+
+// Grafo preparato per i ricalcoli: per ogni timestamp dell'adiacenza il contatto del flusso
+// corrispondente e, nei grafi orientati, gli archi entranti in ogni vertice (in quelli non
+// orientati entranti e uscenti coincidono e bastano forEachNeighbour)
+struct BlackoutGraph
+{
+    const TemporalStorage &storage;
+    ContactView view;
+    vector<uint32_t> slotContacts;
+
+    vector<uint32_t> inOffsets;
+    vector<uint32_t> inTails;
+    vector<uint32_t> inArcs;
+
+    BlackoutGraph(const TemporalStorage &storage);
+
+    template <typename Visit>
+    void forEachIncoming(uint32_t vertex, Visit visit) const
+    {
+        if (!this->storage.directed)
+        {
+            this->storage.forEachNeighbour(vertex, visit);
+            return;
+        }
+        for (uint32_t i = this->inOffsets[vertex]; i < this->inOffsets[vertex + 1]; i++)
+        {
+            visit(this->inTails[i], this->inArcs[i]);
+        }
+    }
+};
+
+BlackoutGraph::BlackoutGraph(const TemporalStorage &storage) : storage(storage), view(makeContactView(storage))
+{
+    // i contatti uguali occupano timestamp consecutivi dello stesso arco
+    this->slotContacts.assign(storage.timestamps.size(), NO_CONTACT);
+    for (uint32_t i = 0; i < storage.contacts.size(); i++)
+    {
+        const Contact &contact = storage.contacts[i];
+        uint32_t arc = storage.findArc(contact.from, contact.to);
+        const int *times = storage.timestamps.data();
+        size_t slot = lower_bound(times + storage.timeOffsets[arc], times + storage.timeOffsets[arc + 1], contact.time) - times;
+        while (this->slotContacts[slot] != NO_CONTACT)
+        {
+            slot++;
+        }
+        this->slotContacts[slot] = i;
+    }
+
+    if (!storage.directed)
+    {
+        return;
+    }
+    uint32_t n = storage.vertexCount();
+    this->inOffsets.assign(n + 1, 0);
+    for (uint32_t head : storage.neighbours)
+    {
+        this->inOffsets[head + 1]++;
+    }
+    for (uint32_t v = 0; v < n; v++)
+    {
+        this->inOffsets[v + 1] += this->inOffsets[v];
+    }
+    this->inTails.resize(storage.neighbours.size());
+    this->inArcs.resize(storage.neighbours.size());
+    vector<uint32_t> next(this->inOffsets.begin(), this->inOffsets.end() - 1);
+    for (uint32_t u = 0; u < n; u++)
+    {
+        for (uint32_t arc = storage.offsets[u]; arc < storage.offsets[u + 1]; arc++)
+        {
+            uint32_t position = next[storage.neighbours[arc]]++;
+            this->inTails[position] = u;
+            this->inArcs[position] = arc;
+        }
+    }
+}
+
+// Albero di earliest arrival da una sorgente e stato del ricalcolo sotto un blackout;
+// i buffer di un worker vengono riusati da una sorgente all'altra
+struct BlackoutTree
+{
+    vector<int> base;
+    vector<uint32_t> parents;
+
+    // figli nell'albero e vertici raggiunti (radice esclusa) per tempo del contatto padre
+    vector<uint32_t> childOffsets;
+    vector<uint32_t> children;
+    vector<uint32_t> byTime;
+    vector<int> times;
+    vector<size_t> windows;
+
+    // sotto il blackout corrente: i vertici che hanno perso il cammino nell'albero
+    // (stamp[v] == current) e per loro il nuovo tempo e il timestamp dell'arco padre
+    vector<uint32_t> stamp;
+    vector<uint32_t> settled;
+    uint32_t current = 0;
+    vector<uint32_t> affected;
+    vector<int> ea;
+    vector<uint32_t> parentSlots;
+
+    vector<uint32_t> stack;
+    vector<pair<int, uint32_t>> heap;
+};
+
+static int blackoutEnd(int start, int length)
+{
+    return min<int64_t>(numeric_limits<int>::max(), int64_t(start) + length - 1);
+}
+
+// estremo del contatto padre diverso da head
+static uint32_t parentTail(const Contact &contact, uint32_t head)
+{
+    return contact.to == head ? contact.from : contact.to;
+}
+
+// primo timestamp dell'arco non inferiore a minTime, NO_CONTACT se non c'e'
+static uint32_t firstSlot(const TemporalStorage &storage, uint32_t arc, int64_t minTime)
+{
+    if (minTime > numeric_limits<int>::max())
+    {
+        return NO_CONTACT;
+    }
+    const int *times = storage.timestamps.data();
+    const int *last = times + storage.timeOffsets[arc + 1];
+    const int *found = lower_bound(times + storage.timeOffsets[arc], last, int(minTime));
+    return found == last ? NO_CONTACT : found - times;
+}
+
+vector<int> blackoutStarts(const TemporalStorage &storage)
+{
+    vector<int> starts;
+    for (const Contact &contact : storage.contacts)
+    {
+        if (starts.empty() || starts.back() != contact.time)
+        {
+            starts.push_back(contact.time);
+        }
+    }
+    return starts;
+}
+
+// Indici (crescenti) dei blackout in starts che tolgono almeno un contatto dell'albero
+static void affectedWindows(const vector<int> &starts, int length, BlackoutTree &tree)
+{
+    // il blackout che inizia in s colpisce il tempo t se s <= t <= s + length - 1
+    tree.windows.clear();
+    size_t next = 0;
+    for (int time : tree.times)
+    {
+        int64_t earliestStart = int64_t(time) - length + 1;
+        size_t first = lower_bound(starts.begin(), starts.end(), earliestStart,
+                                   [](int start, int64_t bound)
+                                   { return start < bound; }) -
+                       starts.begin();
+        size_t last = upper_bound(starts.begin(), starts.end(), time) - starts.begin();
+        for (size_t w = max(first, next); w < last; w++)
+        {
+            tree.windows.push_back(w);
+        }
+        next = max(next, last);
+    }
+}
+
+static void prepareTree(const BlackoutGraph &graph, uint32_t source, JourneyMode mode, const vector<int> &starts,
+                        int length, BlackoutTree &tree)
+{
+    earliestArrivalScan(graph.view, source, mode, tree.base, &tree.parents);
+    uint32_t n = graph.view.vertexCount;
+    const Contact *contacts = graph.view.contacts;
+
+    tree.childOffsets.assign(n + 1, 0);
+    tree.byTime.clear();
+    for (uint32_t v = 0; v < n; v++)
+    {
+        if (tree.parents[v] != NO_CONTACT)
+        {
+            tree.childOffsets[parentTail(contacts[tree.parents[v]], v) + 1]++;
+            tree.byTime.push_back(v);
+        }
+    }
+    for (uint32_t v = 0; v < n; v++)
+    {
+        tree.childOffsets[v + 1] += tree.childOffsets[v];
+    }
+    tree.children.resize(tree.byTime.size());
+    tree.stack.assign(tree.childOffsets.begin(), tree.childOffsets.end() - 1);
+    for (uint32_t v : tree.byTime)
+    {
+        tree.children[tree.stack[parentTail(contacts[tree.parents[v]], v)]++] = v;
+    }
+
+    sort(tree.byTime.begin(), tree.byTime.end(), [&](uint32_t a, uint32_t b)
+         { return contacts[tree.parents[a]].time < contacts[tree.parents[b]].time; });
+    tree.times.clear();
+    for (uint32_t v : tree.byTime)
+    {
+        int time = contacts[tree.parents[v]].time;
+        if (tree.times.empty() || tree.times.back() != time)
+        {
+            tree.times.push_back(time);
+        }
+    }
+    affectedWindows(starts, length, tree);
+
+    if (tree.stamp.size() != n)
+    {
+        tree.stamp.assign(n, 0);
+        tree.settled.assign(n, 0);
+        tree.current = 0;
+        tree.ea.resize(n);
+        tree.parentSlots.resize(n);
+    }
+}
+
+// Raccoglie in tree.affected i vertici il cui cammino nell'albero usa un contatto con tempo
+// in [start, end]: i sottoalberi dei vertici con il contatto padre nel blackout
+static void collectAffected(const BlackoutGraph &graph, int start, int end, BlackoutTree &tree)
+{
+    if (++tree.current == 0)
+    {
+        fill(tree.stamp.begin(), tree.stamp.end(), 0);
+        fill(tree.settled.begin(), tree.settled.end(), 0);
+        tree.current = 1;
+    }
+    tree.affected.clear();
+
+    const Contact *contacts = graph.view.contacts;
+    auto first = lower_bound(tree.byTime.begin(), tree.byTime.end(), start, [&](uint32_t v, int time)
+                             { return contacts[tree.parents[v]].time < time; });
+    for (auto it = first; it != tree.byTime.end() && contacts[tree.parents[*it]].time <= end; ++it)
+    {
+        if (tree.stamp[*it] == tree.current)
+        {
+            continue;
+        }
+        tree.stamp[*it] = tree.current;
+        tree.stack.assign(1, *it);
+        while (!tree.stack.empty())
+        {
+            uint32_t v = tree.stack.back();
+            tree.stack.pop_back();
+            tree.affected.push_back(v);
+            for (uint32_t i = tree.childOffsets[v]; i < tree.childOffsets[v + 1]; i++)
+            {
+                uint32_t child = tree.children[i];
+                if (tree.stamp[child] != tree.current)
+                {
+                    tree.stamp[child] = tree.current;
+                    tree.stack.push_back(child);
+                }
+            }
+        }
+    }
+}
+
+// Earliest arrival dei vertici in tree.affected senza i contatti in [start, end], alla
+// Dijkstra sui timestamp ordinati dell'adiacenza. Gli altri vertici conservano il tempo
+// dell'albero; un vertice colpito ha tempo base >= start, quindi ogni contatto utile che vi
+// entra e' successivo a end: si parte dai contatti che arrivano dai vertici non colpiti e si
+// propaga solo tra i vertici colpiti, senza toccare il resto del grafo.
+static void repairAffected(const BlackoutGraph &graph, int end, JourneyMode mode, BlackoutTree &tree)
+{
+    const TemporalStorage &storage = graph.storage;
+    int64_t strict = mode == JourneyMode::Strict ? 1 : 0;
+    int64_t after = int64_t(end) + 1;
+    greater<pair<int, uint32_t>> later;
+    tree.heap.clear();
+
+    for (uint32_t v : tree.affected)
+    {
+        tree.ea[v] = numeric_limits<int>::max();
+        tree.parentSlots[v] = NO_CONTACT;
+        graph.forEachIncoming(v, [&](uint32_t u, uint32_t arc)
+                              {
+                                  if (u == v || tree.stamp[u] == tree.current || tree.base[u] == numeric_limits<int>::max())
+                                  {
+                                      return;
+                                  }
+                                  uint32_t slot = firstSlot(storage, arc, max(after, tree.base[u] + strict));
+                                  if (slot != NO_CONTACT && storage.timestamps[slot] < tree.ea[v])
+                                  {
+                                      tree.ea[v] = storage.timestamps[slot];
+                                      tree.parentSlots[v] = slot;
+                                  } });
+        if (tree.ea[v] != numeric_limits<int>::max())
+        {
+            tree.heap.push_back({tree.ea[v], v});
+            push_heap(tree.heap.begin(), tree.heap.end(), later);
+        }
+    }
+
+    while (!tree.heap.empty())
+    {
+        pop_heap(tree.heap.begin(), tree.heap.end(), later);
+        auto [time, v] = tree.heap.back();
+        tree.heap.pop_back();
+        if (tree.settled[v] == tree.current || time != tree.ea[v])
+        {
+            continue;
+        }
+        tree.settled[v] = tree.current;
+
+        storage.forEachNeighbour(v, [&](uint32_t w, uint32_t arc)
+                                 {
+                                     if (w == v || tree.stamp[w] != tree.current || tree.settled[w] == tree.current)
+                                     {
+                                         return;
+                                     }
+                                     uint32_t slot = firstSlot(storage, arc, max(after, time + strict));
+                                     if (slot != NO_CONTACT && storage.timestamps[slot] < tree.ea[w])
+                                     {
+                                         tree.ea[w] = storage.timestamps[slot];
+                                         tree.parentSlots[w] = slot;
+                                         tree.heap.push_back({tree.ea[w], w});
+                                         push_heap(tree.heap.begin(), tree.heap.end(), later);
+                                     } });
+    }
+}
+
+static void markContact(uint32_t contact, vector<uint64_t> &bits)
+{
+    bits[contact / 64] |= uint64_t(1) << (contact % 64);
+}
+
+void buildBlackoutSpanner(const TemporalStorage &storage, int length, const vector<uint32_t> &roots,
+                          ThreadPool &pool, JourneyMode mode, TemporalSpanner &spanner)
+{
+    BlackoutGraph graph(storage);
+    vector<int> starts = blackoutStarts(storage);
+    vector<BlackoutTree> trees(pool.size());
+    vector<vector<uint64_t>> workerBits(pool.size(), vector<uint64_t>((storage.contacts.size() + 63) / 64, 0));
+
+    pool.parallelFor(roots.size(), [&](size_t r, unsigned w)
+                     {
+                         BlackoutTree &tree = trees[w];
+                         prepareTree(graph, roots[r], mode, starts, length, tree);
+                         for (uint32_t v : tree.byTime)
+                         {
+                             markContact(tree.parents[v], workerBits[w]);
+                         }
+
+                         for (size_t window : tree.windows)
+                         {
+                             int end = blackoutEnd(starts[window], length);
+                             collectAffected(graph, starts[window], end, tree);
+                             repairAffected(graph, end, mode, tree);
+                             for (uint32_t v : tree.affected)
+                             {
+                                 if (tree.parentSlots[v] != NO_CONTACT)
+                                 {
+                                     markContact(graph.slotContacts[tree.parentSlots[v]], workerBits[w]);
+                                 }
+                             }
+                         } });
+
+    mergeSpanner(graph.view, pool, workerBits, spanner);
+}
+
+bool verifyBlackoutSpanner(const TemporalStorage &graph, const TemporalStorage &subgraph, int length,
+                           const vector<uint32_t> &sources, ThreadPool &pool, JourneyMode mode,
+                           BlackoutWitness *witness)
+{
+    if (subgraph.vertexCount() != graph.vertexCount() || subgraph.directed != graph.directed)
+    {
+        throw invalid_argument("il sottografo non usa gli id del grafo");
+    }
+    BlackoutGraph full(graph);
+    BlackoutGraph sub(subgraph);
+    vector<int> starts = blackoutStarts(graph);
+    vector<BlackoutTree> fullTrees(pool.size());
+    vector<BlackoutTree> subTrees(pool.size());
+    vector<vector<uint32_t>> missing(pool.size());
+    atomic<bool> failed(false);
+    mutex witnessLock;
+
+    auto fail = [&](uint32_t source, uint32_t vertex, bool blackout, int windowStart)
+    {
+        lock_guard<mutex> guard(witnessLock);
+        if (!failed.exchange(true) && witness != nullptr)
+        {
+            *witness = {source, vertex, blackout, windowStart};
+        }
+    };
+
+    pool.parallelFor(sources.size(), [&](size_t s, unsigned w)
+                     {
+                         if (failed.load(memory_order_relaxed))
+                         {
+                             return;
+                         }
+                         BlackoutTree &fullTree = fullTrees[w];
+                         BlackoutTree &subTree = subTrees[w];
+                         uint32_t source = sources[s];
+
+                         prepareTree(full, source, mode, starts, length, fullTree);
+                         prepareTree(sub, source, mode, starts, length, subTree);
+                         for (uint32_t v = 0; v < graph.vertexCount(); v++)
+                         {
+                             if (fullTree.base[v] != numeric_limits<int>::max() && subTree.base[v] == numeric_limits<int>::max())
+                             {
+                                 fail(source, v, false, 0);
+                                 return;
+                             }
+                         }
+
+                         for (size_t window : subTree.windows)
+                         {
+                             if (failed.load(memory_order_relaxed))
+                             {
+                                 return;
+                             }
+                             int start = starts[window];
+                             int end = blackoutEnd(start, length);
+                             collectAffected(sub, start, end, subTree);
+                             repairAffected(sub, end, mode, subTree);
+
+                             // vertici persi nel sottografo ma raggiungibili nel grafo senza blackout
+                             missing[w].clear();
+                             for (uint32_t v : subTree.affected)
+                             {
+                                 if (subTree.ea[v] == numeric_limits<int>::max() && fullTree.base[v] != numeric_limits<int>::max())
+                                 {
+                                     missing[w].push_back(v);
+                                 }
+                             }
+                             if (missing[w].empty())
+                             {
+                                 continue;
+                             }
+
+                             // solo ora serve il grafo con il blackout
+                             collectAffected(full, start, end, fullTree);
+                             repairAffected(full, end, mode, fullTree);
+                             for (uint32_t v : missing[w])
+                             {
+                                 bool lost = fullTree.stamp[v] == fullTree.current && fullTree.ea[v] == numeric_limits<int>::max();
+                                 if (!lost)
+                                 {
+                                     fail(source, v, true, start);
+                                     return;
+                                 }
+                             }
+                         } });
+
+    return !failed.load();
+}
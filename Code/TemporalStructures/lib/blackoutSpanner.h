@@ -0,0 +1,49 @@
+#ifndef BLACKOUTSPANNER_H
+#define BLACKOUTSPANNER_H
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "temporalSpanner.h"
+
+using namespace std;
+
+// Un blackout di lunghezza length che inizia in start rende inutilizzabili tutti i contatti
+// con tempo in [start, start + length - 1]; con length = 1 e' il blackout di un solo istante.
+// Bastano i blackout che iniziano a un istante in cui c'e' almeno un contatto: ogni altro
+// blackout toglie gli stessi contatti di uno di questi o nessuno.
+vector<int> blackoutStarts(const TemporalStorage &storage);
+
+// Sottografo tollerante ai blackout di lunghezza length: per ogni radice s contiene
+// l'albero di earliest arrival T_s del grafo intero e, per ogni blackout che colpisce un
+// contatto di T_s, i padri dei vertici che sotto quel blackout hanno perso il cammino
+// nell'albero. Gli altri vertici conservano il loro cammino in T_s, quindi sotto ogni
+// blackout i tempi di arrivo da ogni radice (e la connettivita' temporale) restano quelli
+// del grafo. Le radici vengono distribuite sul pool.
+void buildBlackoutSpanner(const TemporalStorage &storage, int length, const vector<uint32_t> &roots,
+                          ThreadPool &pool, JourneyMode mode, TemporalSpanner &spanner);
+
+// Primo controllo fallito da verifyBlackoutSpanner: da source, vertex e' raggiungibile nel
+// grafo ma non nel sottografo, sotto il blackout che inizia in windowStart (o senza blackout)
+struct BlackoutWitness
+{
+    uint32_t source = NO_VERTEX;
+    uint32_t vertex = NO_VERTEX;
+    bool blackout = false;
+    int windowStart = 0;
+};
+
+// Verifica che subgraph (stessi id di graph: invalid_argument se il numero di vertici o
+// l'orientamento sono diversi) conservi la connettivita' temporale da ogni
+// sorgente sotto ogni blackout di lunghezza length. Per ogni sorgente si considerano solo i
+// blackout che colpiscono il suo albero nel sottografo e solo i vertici che perdono il
+// cammino nell'albero: gli altri raggiungono nel sottografo tutto cio' che si raggiunge senza
+// blackout, che e' un sovrainsieme di quanto si raggiunge nel grafo con il blackout. Anche
+// nel grafo si ricalcola solo se serve. Le sorgenti vengono distribuite sul pool e la
+// verifica si ferma al primo controllo fallito, riportato in witness se non nullo.
+bool verifyBlackoutSpanner(const TemporalStorage &graph, const TemporalStorage &subgraph, int length,
+                           const vector<uint32_t> &sources, ThreadPool &pool, JourneyMode mode,
+                           BlackoutWitness *witness);
+
+#endif
@@ -0,0 +1,343 @@
+#include "dynamicEarliestArrival.h"
+
+#include <algorithm>
+#include <functional>
+
+using namespace std;
+
+// primo timestamp dell'arco non inferiore a minTime, INT_MAX se non c'e'
+static int firstTime(const TemporalStorage &storage, uint32_t arc, int64_t minTime)
+{
+    if (minTime > numeric_limits<int>::max())
+    {
+        return numeric_limits<int>::max();
+    }
+    auto last = storage.timestamps.begin() + storage.timeOffsets[arc + 1];
+    auto found = lower_bound(storage.timestamps.begin() + storage.timeOffsets[arc], last, int(minTime));
+    return found == last ? numeric_limits<int>::max() : *found;
+}
+
+DynamicEarliestArrival::DynamicEarliestArrival(const TemporalStorage &storage, const vector<uint32_t> &sources,
+                                               JourneyMode mode)
+{
+    this->mode = mode;
+    for (uint32_t source : sources)
+    {
+        this->trees.push_back({source, {}, {}, {}, {}});
+    }
+    this->resize(storage);
+
+    if (storage.directed)
+    {
+        for (uint32_t u = 0; u < storage.vertexCount(); u++)
+        {
+            for (uint32_t arc = storage.offsets[u]; arc < storage.offsets[u + 1]; arc++)
+            {
+                this->incoming[storage.neighbours[arc]].push_back(u);
+            }
+        }
+    }
+
+    for (DynamicTree &tree : this->trees)
+    {
+        this->restartSource(storage, tree);
+    }
+    this->stats = DynamicStats();
+}
+
+size_t DynamicEarliestArrival::treeOf(uint32_t source) const
+{
+    for (size_t i = 0; i < this->trees.size(); i++)
+    {
+        if (this->trees[i].source == source)
+        {
+            return i;
+        }
+    }
+    return this->trees.size();
+}
+
+void DynamicEarliestArrival::resize(const TemporalStorage &storage)
+{
+    uint32_t n = storage.vertexCount();
+    for (DynamicTree &tree : this->trees)
+    {
+        tree.ea.resize(n, numeric_limits<int>::max());
+        tree.parent.resize(n, NO_VERTEX);
+        tree.parentTime.resize(n, 0);
+        tree.children.resize(n);
+    }
+    this->stamp.resize(n, 0);
+    if (storage.directed)
+    {
+        this->incoming.resize(n);
+    }
+}
+
+template <typename Visit>
+void DynamicEarliestArrival::forEachIncoming(const TemporalStorage &storage, uint32_t vertex, Visit visit)
+{
+    if (!storage.directed)
+    {
+        storage.forEachNeighbour(vertex, visit);
+        return;
+    }
+    for (uint32_t tail : this->incoming[vertex])
+    {
+        uint32_t arc = storage.findArc(tail, vertex);
+        if (arc != NO_ARC)
+        {
+            visit(tail, arc);
+        }
+    }
+}
+
+void DynamicEarliestArrival::setParent(DynamicTree &tree, uint32_t vertex, uint32_t parent, int time)
+{
+    if (tree.parent[vertex] != NO_VERTEX)
+    {
+        vector<uint32_t> &siblings = tree.children[tree.parent[vertex]];
+        siblings.erase(find(siblings.begin(), siblings.end(), vertex));
+    }
+    tree.parent[vertex] = parent;
+    tree.parentTime[vertex] = time;
+    tree.children[parent].push_back(vertex);
+}
+
+void DynamicEarliestArrival::push(DynamicTree &tree, uint32_t vertex)
+{
+    this->heap.push_back({tree.ea[vertex], vertex});
+    push_heap(this->heap.begin(), this->heap.end(), greater<pair<int, uint32_t>>());
+}
+
+// Propagazione alla Dijkstra dai vertici nello heap: un vertice estratto ha il tempo
+// definitivo e fissa i vicini con il primo timestamp utilizzabile di ogni arco uscente.
+// Con onlyAffected si aggiornano solo i vertici invalidati da invalidate.
+void DynamicEarliestArrival::propagate(const TemporalStorage &storage, DynamicTree &tree, bool onlyAffected)
+{
+    int64_t strict = this->mode == JourneyMode::Strict ? 1 : 0;
+    while (!this->heap.empty())
+    {
+        pop_heap(this->heap.begin(), this->heap.end(), greater<pair<int, uint32_t>>());
+        auto [time, v] = this->heap.back();
+        this->heap.pop_back();
+        if (time != tree.ea[v])
+        {
+            continue;
+        }
+        this->stats.touchedVertices++;
+
+        storage.forEachNeighbour(v, [&](uint32_t w, uint32_t arc)
+                                 {
+                                     this->stats.scannedArcs++;
+                                     if (w == v || (onlyAffected && this->stamp[w] != this->current))
+                                     {
+                                         return;
+                                     }
+                                     int arrival = firstTime(storage, arc, time + strict);
+                                     if (arrival < tree.ea[w])
+                                     {
+                                         tree.ea[w] = arrival;
+                                         this->setParent(tree, w, v, arrival);
+                                         this->push(tree, w);
+                                     } });
+    }
+}
+
+// Stacca dall'albero i sottoalberi delle radici indicate e li raccoglie in affected
+void DynamicEarliestArrival::invalidate(DynamicTree &tree, const vector<uint32_t> &roots)
+{
+    if (++this->current == 0)
+    {
+        fill(this->stamp.begin(), this->stamp.end(), 0);
+        this->current = 1;
+    }
+    this->affected.clear();
+
+    for (uint32_t root : roots)
+    {
+        if (this->stamp[root] == this->current || tree.ea[root] == numeric_limits<int>::max())
+        {
+            continue;
+        }
+        if (tree.parent[root] != NO_VERTEX)
+        {
+            vector<uint32_t> &siblings = tree.children[tree.parent[root]];
+            siblings.erase(find(siblings.begin(), siblings.end(), root));
+        }
+        this->stamp[root] = this->current;
+        this->stack.assign(1, root);
+        while (!this->stack.empty())
+        {
+            uint32_t v = this->stack.back();
+            this->stack.pop_back();
+            this->affected.push_back(v);
+            for (uint32_t child : tree.children[v])
+            {
+                if (this->stamp[child] != this->current)
+                {
+                    this->stamp[child] = this->current;
+                    this->stack.push_back(child);
+                }
+            }
+        }
+    }
+
+    for (uint32_t v : this->affected)
+    {
+        tree.ea[v] = numeric_limits<int>::max();
+        tree.parent[v] = NO_VERTEX;
+        tree.children[v].clear();
+    }
+    this->stats.touchedVertices += this->affected.size();
+}
+
+// Ricalcola i vertici invalidati: gli altri conservano un viaggio valido, quindi si parte
+// dagli archi che entrano nei vertici invalidati dal resto dell'albero. Se lo storage ha
+// solo perso contatti i vertici non invalidati restano ottimi e la propagazione si ferma ai
+// vertici invalidati; altrimenti un vertice ricalcolato puo' migliorare anche gli altri.
+void DynamicEarliestArrival::repair(const TemporalStorage &storage, DynamicTree &tree, bool onlyAffected)
+{
+    int64_t strict = this->mode == JourneyMode::Strict ? 1 : 0;
+    this->heap.clear();
+    for (uint32_t v : this->affected)
+    {
+        this->forEachIncoming(storage, v, [&](uint32_t u, uint32_t arc)
+                              {
+                                  this->stats.scannedArcs++;
+                                  if (u == v || this->stamp[u] == this->current || tree.ea[u] == numeric_limits<int>::max())
+                                  {
+                                      return;
+                                  }
+                                  int arrival = firstTime(storage, arc, tree.ea[u] + strict);
+                                  if (arrival < tree.ea[v])
+                                  {
+                                      tree.ea[v] = arrival;
+                                      this->setParent(tree, v, u, arrival);
+                                  } });
+        if (tree.ea[v] != numeric_limits<int>::max())
+        {
+            this->push(tree, v);
+        }
+    }
+    this->propagate(storage, tree, onlyAffected);
+}
+
+// (ri)calcola da zero l'albero di una sorgente viva che non raggiunge nemmeno se stessa
+void DynamicEarliestArrival::restartSource(const TemporalStorage &storage, DynamicTree &tree)
+{
+    if (!storage.isAlive(tree.source) || tree.ea[tree.source] != numeric_limits<int>::max())
+    {
+        return;
+    }
+    tree.ea[tree.source] = numeric_limits<int>::min();
+    this->heap.clear();
+    this->push(tree, tree.source);
+    this->propagate(storage, tree, false);
+}
+
+void DynamicEarliestArrival::arcChanged(const TemporalStorage &storage, uint32_t start, uint32_t end,
+                                        const vector<int> &oldTimes)
+{
+    this->resize(storage);
+    this->stats.updates++;
+
+    uint32_t arc = storage.findArc(start, end);
+    if (storage.directed)
+    {
+        vector<uint32_t> &tails = this->incoming[end];
+        auto found = find(tails.begin(), tails.end(), start);
+        if (arc == NO_ARC && found != tails.end())
+        {
+            tails.erase(found);
+        }
+        else if (arc != NO_ARC && found == tails.end())
+        {
+            tails.push_back(start);
+        }
+    }
+
+    vector<int> newTimes;
+    if (arc != NO_ARC)
+    {
+        newTimes.assign(storage.timestamps.begin() + storage.timeOffsets[arc],
+                        storage.timestamps.begin() + storage.timeOffsets[arc + 1]);
+    }
+    int64_t strict = this->mode == JourneyMode::Strict ? 1 : 0;
+
+    for (DynamicTree &tree : this->trees)
+    {
+        this->restartSource(storage, tree);
+        if (start == end)
+        {
+            continue;
+        }
+
+        // contatti rimossi: cade il sottoalbero di un vertice il cui contatto padre non c'e' piu'
+        vector<uint32_t> roots;
+        auto lost = [&](uint32_t tail, uint32_t head)
+        {
+            return tree.parent[head] == tail && binary_search(oldTimes.begin(), oldTimes.end(), tree.parentTime[head]) &&
+                   !binary_search(newTimes.begin(), newTimes.end(), tree.parentTime[head]);
+        };
+        if (lost(start, end))
+        {
+            roots.push_back(end);
+        }
+        if (!storage.directed && lost(end, start))
+        {
+            roots.push_back(start);
+        }
+        if (!roots.empty())
+        {
+            this->invalidate(tree, roots);
+            this->repair(storage, tree, includes(oldTimes.begin(), oldTimes.end(), newTimes.begin(), newTimes.end()));
+        }
+
+        // contatti inseriti: solo la testa dell'arco puo' migliorare, poi si propaga
+        if (arc == NO_ARC)
+        {
+            continue;
+        }
+        this->heap.clear();
+        auto relax = [&](uint32_t tail, uint32_t head)
+        {
+            if (tree.ea[tail] == numeric_limits<int>::max())
+            {
+                return;
+            }
+            int arrival = firstTime(storage, arc, tree.ea[tail] + strict);
+            if (arrival < tree.ea[head])
+            {
+                tree.ea[head] = arrival;
+                this->setParent(tree, head, tail, arrival);
+                this->push(tree, head);
+            }
+        };
+        relax(start, end);
+        if (!storage.directed)
+        {
+            relax(end, start);
+        }
+        this->propagate(storage, tree, false);
+    }
+}
+
+void DynamicEarliestArrival::vertexRemoved(const TemporalStorage &storage, uint32_t vertex)
+{
+    this->resize(storage);
+    this->stats.updates++;
+    if (storage.directed)
+    {
+        this->incoming[vertex].clear();
+    }
+
+    for (DynamicTree &tree : this->trees)
+    {
+        if (tree.ea[vertex] != numeric_limits<int>::max())
+        {
+            this->invalidate(tree, {vertex});
+            this->repair(storage, tree, true);
+        }
+    }
+}
@@ -0,0 +1,85 @@
+#ifndef DYNAMICEARLIESTARRIVAL_H
+#define DYNAMICEARLIESTARRIVAL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "temporalScan.h"
+
+using namespace std;
+
+// Costi cumulati degli aggiornamenti: il costo ammortizzato di un aggiornamento e'
+// touchedVertices / updates (vertici ricalcolati) e scannedArcs / updates (archi esaminati)
+struct DynamicStats
+{
+    size_t updates = 0;
+    size_t touchedVertices = 0;
+    size_t scannedArcs = 0;
+};
+
+// Albero di earliest arrival di una sorgente monitorata: per ogni vertice raggiunto il
+// padre e il tempo del contatto padre, oltre ai figli per visitare i sottoalberi
+struct DynamicTree
+{
+    uint32_t source;
+    vector<int> ea;
+    vector<uint32_t> parent;
+    vector<int> parentTime;
+    vector<vector<uint32_t>> children;
+};
+
+// Mantiene gli alberi di earliest arrival di un insieme fisso di sorgenti mentre lo storage
+// cambia. Dopo ogni modifica dello storage va chiamato l'aggiornamento corrispondente:
+// un contatto inserito fa ripartire una propagazione alla Dijkstra dal solo vertice che
+// migliora, un contatto rimosso invalida solo il sottoalbero appeso al contatto e lo
+// ricalcola a partire dagli archi che vi entrano dal resto dell'albero.
+// L'adiacenza uscente e i timestamp ordinati sono quelli dello storage; per i grafi
+// orientati si tiene in piu' l'elenco delle origini degli archi entranti in ogni vertice.
+class DynamicEarliestArrival
+{
+
+public:
+    JourneyMode mode;
+    vector<DynamicTree> trees;
+    DynamicStats stats;
+
+    // solo per i grafi orientati: incoming[v] contiene le origini degli archi u -> v
+    // (con possibili voci di archi rimossi insieme a un vertice, scartate all'uso)
+    vector<vector<uint32_t>> incoming;
+
+    DynamicEarliestArrival(const TemporalStorage &storage, const vector<uint32_t> &sources, JourneyMode mode);
+
+    // indice in trees dell'albero di source, trees.size() se source non e' monitorata
+    size_t treeOf(uint32_t source) const;
+
+    // adegua le strutture a nuovi vertici dello storage
+    void resize(const TemporalStorage &storage);
+
+    // l'arco (start, end) dello storage aveva i timestamp ordinati oldTimes (vuoto se non
+    // esisteva) e ora ha quelli attuali nello storage, eventualmente nessuno se e' stato rimosso
+    void arcChanged(const TemporalStorage &storage, uint32_t start, uint32_t end, const vector<int> &oldTimes);
+
+    // vertex e' stato rimosso dallo storage insieme ai suoi archi
+    void vertexRemoved(const TemporalStorage &storage, uint32_t vertex);
+
+private:
+    vector<uint32_t> stamp;
+    uint32_t current = 0;
+    vector<uint32_t> affected;
+    vector<uint32_t> stack;
+    vector<pair<int, uint32_t>> heap;
+
+    template <typename Visit>
+    void forEachIncoming(const TemporalStorage &storage, uint32_t vertex, Visit visit);
+
+    void setParent(DynamicTree &tree, uint32_t vertex, uint32_t parent, int time);
+    void push(DynamicTree &tree, uint32_t vertex);
+    void propagate(const TemporalStorage &storage, DynamicTree &tree, bool onlyAffected);
+    void invalidate(DynamicTree &tree, const vector<uint32_t> &roots);
+    void repair(const TemporalStorage &storage, DynamicTree &tree, bool onlyAffected);
+    void restartSource(const TemporalStorage &storage, DynamicTree &tree);
+};
+
+#endif
@@ -0,0 +1,146 @@
+#include "multiSourceScan.h"
+
+#include <stdexcept>
+
+using namespace std;
+
+template <size_t Width>
+static void initLanes(vector<SourceLanes<Width>> &state, uint32_t vertexCount, const uint32_t *sources, size_t count,
+                      int unreachedTime, int sourceTime)
+{
+    SourceLanes<Width> unreached;
+    for (size_t k = 0; k < Width; k++)
+    {
+        unreached.lane[k] = unreachedTime;
+    }
+    state.assign(vertexCount, unreached);
+    for (size_t k = 0; k < count; k++)
+    {
+        state[sources[k]].lane[k] = sourceTime;
+    }
+}
+
+template <size_t Width>
+void earliestArrivalBlock(const ContactView &view, const uint32_t *sources, size_t count, JourneyMode mode,
+                          vector<SourceLanes<Width>> &state, GroupScratch &scratch)
+{
+    initLanes<Width>(state, view.vertexCount, sources, count, numeric_limits<int>::max(), numeric_limits<int>::min());
+
+    auto relaxNonStrict = [&](size_t i, uint32_t tail, uint32_t head)
+    {
+        return tail != head && relaxLanes<Width, false>(state[tail], state[head], view.contacts[i].time);
+    };
+    auto relaxStrict = [&](size_t i, uint32_t tail, uint32_t head)
+    {
+        return tail != head && relaxLanes<Width, true>(state[tail], state[head], view.contacts[i].time);
+    };
+
+    // una corsia migliora al piu' una volta per gruppo, quindi in un gruppo ogni
+    // vertice rientra in coda al piu' Width volte
+    if (mode == JourneyMode::Strict)
+    {
+        scanTimeGroups(view, true, mode, scratch, relaxStrict);
+    }
+    else
+    {
+        scanTimeGroups(view, true, mode, scratch, relaxNonStrict);
+    }
+}
+
+template <size_t Width>
+void latestDepartureBlock(const ContactView &view, const uint32_t *destinations, size_t count, JourneyMode mode,
+                          vector<SourceLanes<Width>> &state, GroupScratch &scratch)
+{
+    initLanes<Width>(state, view.vertexCount, destinations, count, numeric_limits<int>::min(), numeric_limits<int>::max());
+
+    auto relaxNonStrict = [&](size_t i, uint32_t tail, uint32_t head)
+    {
+        return tail != head && relaxLanesLatest<Width, false>(state[tail], state[head], view.contacts[i].time);
+    };
+    auto relaxStrict = [&](size_t i, uint32_t tail, uint32_t head)
+    {
+        return tail != head && relaxLanesLatest<Width, true>(state[tail], state[head], view.contacts[i].time);
+    };
+
+    if (mode == JourneyMode::Strict)
+    {
+        scanTimeGroups(view, false, mode, scratch, relaxStrict);
+    }
+    else
+    {
+        scanTimeGroups(view, false, mode, scratch, relaxNonStrict);
+    }
+}
+
+template <size_t Width, bool Earliest>
+static void batchWidth(const ContactView &view, const vector<uint32_t> &sources, JourneyMode mode, vector<int> &result)
+{
+    vector<SourceLanes<Width>> state;
+    GroupScratch scratch;
+
+    for (size_t blockBegin = 0; blockBegin < sources.size(); blockBegin += Width)
+    {
+        size_t count = min(Width, sources.size() - blockBegin);
+        if (Earliest)
+        {
+            earliestArrivalBlock<Width>(view, sources.data() + blockBegin, count, mode, state, scratch);
+        }
+        else
+        {
+            latestDepartureBlock<Width>(view, sources.data() + blockBegin, count, mode, state, scratch);
+        }
+
+        for (size_t k = 0; k < count; k++)
+        {
+            int *row = result.data() + (blockBegin + k) * view.vertexCount;
+            for (uint32_t v = 0; v < view.vertexCount; v++)
+            {
+                row[v] = state[v].lane[k];
+            }
+        }
+    }
+}
+
+template <bool Earliest>
+static void batch(const ContactView &view, const vector<uint32_t> &sources, JourneyMode mode, size_t width,
+                  vector<int> &result)
+{
+    result.resize(sources.size() * view.vertexCount);
+
+    switch (width)
+    {
+    case 8:
+        batchWidth<8, Earliest>(view, sources, mode, result);
+        break;
+    case 16:
+        batchWidth<16, Earliest>(view, sources, mode, result);
+        break;
+    case 32:
+        batchWidth<32, Earliest>(view, sources, mode, result);
+        break;
+    default:
+        throw invalid_argument("la larghezza del blocco di sorgenti deve essere 8, 16 o 32");
+    }
+}
+
+void earliestArrivalBatch(const ContactView &view, const vector<uint32_t> &sources, JourneyMode mode,
+                          size_t width, vector<int> &result)
+{
+    batch<true>(view, sources, mode, width, result);
+}
+
+void latestDepartureBatch(const ContactView &view, const vector<uint32_t> &destinations, JourneyMode mode,
+                          size_t width, vector<int> &result)
+{
+    batch<false>(view, destinations, mode, width, result);
+}
+
+#define INSTANTIATE_BLOCKS(WIDTH)                                                                                  \
+    template void earliestArrivalBlock<WIDTH>(const ContactView &, const uint32_t *, size_t, JourneyMode,          \
+                                              vector<SourceLanes<WIDTH>> &, GroupScratch &);                       \
+    template void latestDepartureBlock<WIDTH>(const ContactView &, const uint32_t *, size_t, JourneyMode,          \
+                                              vector<SourceLanes<WIDTH>> &, GroupScratch &);
+
+INSTANTIATE_BLOCKS(8)
+INSTANTIATE_BLOCKS(16)
+INSTANTIATE_BLOCKS(32)
@@ -0,0 +1,77 @@
+#ifndef MULTISOURCESCAN_H
+#define MULTISOURCESCAN_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "temporalScan.h"
+
+using namespace std;
+
+// Stato di un vertice per un blocco di Width sorgenti (structure of arrays):
+// lane[k] e' il tempo di arrivo dalla k-esima sorgente del blocco.
+template <size_t Width>
+struct alignas(Width * sizeof(int)) SourceLanes
+{
+    int lane[Width];
+};
+
+// Rilassa il contatto tail -> head al tempo time su tutte le corsie del blocco.
+// Il ciclo non ha dipendenze tra corsie, quindi il compilatore lo traduce in
+// un confronto/minimo vettoriale. tail e head devono essere vertici distinti
+// (i cappi non migliorano mai nulla e vanno scartati prima): __restrict permette
+// al compilatore di non ricaricare le corsie dopo ogni scrittura.
+// Restituisce true se almeno una corsia e' migliorata.
+template <size_t Width, bool Strict>
+inline bool relaxLanes(const SourceLanes<Width> &__restrict tail, SourceLanes<Width> &__restrict head, int time)
+{
+    int changed = 0;
+    for (size_t k = 0; k < Width; k++)
+    {
+        bool usable = Strict ? tail.lane[k] < time : tail.lane[k] <= time;
+        bool better = usable & (time < head.lane[k]);
+        head.lane[k] = better ? time : head.lane[k];
+        changed |= better;
+    }
+    return changed != 0;
+}
+
+// Come relaxLanes ma per il latest departure: l'informazione va dalla testa del
+// contatto (tail) alla sua coda (head) e si tiene il massimo.
+template <size_t Width, bool Strict>
+inline bool relaxLanesLatest(const SourceLanes<Width> &__restrict tail, SourceLanes<Width> &__restrict head, int time)
+{
+    int changed = 0;
+    for (size_t k = 0; k < Width; k++)
+    {
+        bool usable = Strict ? time < tail.lane[k] : time <= tail.lane[k];
+        bool better = usable & (time > head.lane[k]);
+        head.lane[k] = better ? time : head.lane[k];
+        changed |= better;
+    }
+    return changed != 0;
+}
+
+// Earliest arrival per un blocco di al piu' Width sorgenti in un'unica scansione.
+// state viene ridimensionato a vertexCount e riusato tra un blocco e l'altro.
+template <size_t Width>
+void earliestArrivalBlock(const ContactView &view, const uint32_t *sources, size_t count, JourneyMode mode,
+                          vector<SourceLanes<Width>> &state, GroupScratch &scratch);
+
+// Latest departure verso un blocco di al piu' Width destinazioni in un'unica scansione all'indietro.
+template <size_t Width>
+void latestDepartureBlock(const ContactView &view, const uint32_t *destinations, size_t count, JourneyMode mode,
+                          vector<SourceLanes<Width>> &state, GroupScratch &scratch);
+
+// Earliest arrival da tutte le sorgenti indicate, a blocchi di width (8, 16 o 32) sorgenti.
+// Il risultato e' una matrice sources.size() x vertexCount per righe:
+// result[i * vertexCount + v] e' il tempo di arrivo in v partendo da sources[i].
+void earliestArrivalBatch(const ContactView &view, const vector<uint32_t> &sources, JourneyMode mode,
+                          size_t width, vector<int> &result);
+
+// Latest departure verso tutte le destinazioni indicate, con la stessa disposizione del risultato.
+void latestDepartureBatch(const ContactView &view, const vector<uint32_t> &destinations, JourneyMode mode,
+                          size_t width, vector<int> &result);
+
+#endif
@@ -0,0 +1,98 @@
+#include "pointToPoint.h"
+
+#include <algorithm>
+
+using namespace std;
+
+// Tempo del primo contatto usabile in partenza da source (INT_MAX se non ce ne sono):
+// ogni arco ha i timestamp ordinati, quindi basta una ricerca binaria per arco
+static int firstUsefulContact(const TemporalStorage &storage, uint32_t source, int departure)
+{
+    int first = numeric_limits<int>::max();
+    storage.forEachNeighbour(source, [&](uint32_t, uint32_t arc)
+                             {
+                                 const int *begin = storage.timestamps.data() + storage.timeOffsets[arc];
+                                 const int *end = storage.timestamps.data() + storage.timeOffsets[arc + 1];
+                                 const int *useful = lower_bound(begin, end, departure);
+                                 if (useful != end)
+                                 {
+                                     first = min(first, *useful);
+                                 } });
+    return first;
+}
+
+int pointToPointEarliestArrival(const TemporalStorage &storage, uint32_t source, uint32_t target, int departure,
+                                int timeEnd, JourneyMode mode, PointToPointScratch &scratch)
+{
+    TEMPORAL_PHASE("pointToPoint");
+    TEMPORAL_COUNT(queries, 1);
+    if (source == NO_VERTEX || target == NO_VERTEX)
+    {
+        return numeric_limits<int>::max();
+    }
+    if (source == target)
+    {
+        return departure;
+    }
+
+    uint32_t n = storage.vertexCount();
+    if (scratch.stamp.size() < n)
+    {
+        scratch.ea.resize(n);
+        scratch.stamp.resize(n, 0);
+    }
+    if (++scratch.generation == 0)
+    {
+        fill(scratch.stamp.begin(), scratch.stamp.end(), 0);
+        scratch.generation = 1;
+    }
+    uint32_t generation = scratch.generation;
+    auto arrival = [&scratch, generation](uint32_t v)
+    {
+        return scratch.stamp[v] == generation ? scratch.ea[v] : numeric_limits<int>::max();
+    };
+    scratch.ea[source] = numeric_limits<int>::min();
+    scratch.stamp[source] = generation;
+
+    // prima del primo contatto utile della sorgente non succede nulla
+    int start = firstUsefulContact(storage, source, departure);
+    if (start > timeEnd)
+    {
+        return numeric_limits<int>::max();
+    }
+    ContactView view = timeWindow(makeContactView(storage), start, timeEnd);
+
+    bool strict = mode == JourneyMode::Strict;
+    auto relax = [&](size_t i, uint32_t tail, uint32_t head)
+    {
+        int tailArrival = arrival(tail);
+        if (tailArrival == numeric_limits<int>::max())
+        {
+            return false;
+        }
+        int time = view.contacts[i].time;
+        bool usable = strict ? tailArrival < time : tailArrival <= time;
+        if (usable && time < arrival(head))
+        {
+            scratch.ea[head] = time;
+            scratch.stamp[head] = generation;
+            TEMPORAL_COUNT(relaxations, 1);
+            return true;
+        }
+        return false;
+    };
+
+    // un gruppo di timestamp alla volta, finche' un contatto puo' ancora anticipare target
+    ContactView group = view;
+    for (group.first = view.first; group.first < view.last && view.contacts[group.first].time < arrival(target);
+         group.first = group.last)
+    {
+        group.last = group.first + 1;
+        while (group.last < view.last && view.contacts[group.last].time == view.contacts[group.first].time)
+        {
+            group.last++;
+        }
+        scanTimeGroups(group, true, mode, scratch.group, relax);
+    }
+    return arrival(target);
+}
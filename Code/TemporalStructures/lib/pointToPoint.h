@@ -0,0 +1,31 @@
+#ifndef POINTTOPOINT_H
+#define POINTTOPOINT_H
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "temporalScan.h"
+
+using namespace std;
+
+// Buffer della query punto a punto, riusati da una query all'altra: ea[v] vale solo se
+// stamp[v] == generation, cosi' una query non paga l'azzeramento di tutti i vertici
+struct PointToPointScratch
+{
+    vector<int> ea;
+    vector<uint32_t> stamp;
+    uint32_t generation = 0;
+    GroupScratch group;
+};
+
+// Earliest arrival in target partendo da source non prima di departure, usando solo
+// contatti con tempo <= timeEnd (departure se coincidono, INT_MAX se irraggiungibile).
+// La scansione parte dal primo contatto utile della sorgente, trovato con una ricerca
+// binaria sui suoi archi, ignora i contatti il cui estremo di partenza non e' ancora
+// raggiunto e si ferma al primo gruppo di timestamp che non puo' piu' anticipare target:
+// tocca solo i contatti tra la partenza e l'arrivo in target.
+int pointToPointEarliestArrival(const TemporalStorage &storage, uint32_t source, uint32_t target, int departure,
+                                int timeEnd, JourneyMode mode, PointToPointScratch &scratch);
+
+#endif
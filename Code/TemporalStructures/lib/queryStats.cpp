@@ -0,0 +1,171 @@
+#include "queryStats.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <new>
+#include <stdexcept>
+
+using namespace std;
+
+// contatore banale, cosi' operator new puo' usarlo anche durante la costruzione o la
+// distruzione delle statistiche del thread
+static thread_local uint64_t allocationCount = 0;
+static thread_local uint64_t allocationBase = 0;
+
+#ifdef TEMPORAL_INSTRUMENTATION
+void *operator new(size_t size)
+{
+    allocationCount++;
+    void *memory = malloc(size == 0 ? 1 : size);
+    if (memory == nullptr)
+    {
+        throw bad_alloc();
+    }
+    return memory;
+}
+
+void *operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void *memory) noexcept
+{
+    free(memory);
+}
+
+void operator delete[](void *memory) noexcept
+{
+    free(memory);
+}
+
+void operator delete(void *memory, size_t) noexcept
+{
+    free(memory);
+}
+
+void operator delete[](void *memory, size_t) noexcept
+{
+    free(memory);
+}
+
+// tipi sovrallineati (per esempio le corsie SIMD delle scansioni multi-sorgente)
+void *operator new(size_t size, align_val_t alignment)
+{
+    allocationCount++;
+    size_t align = max(size_t(alignment), sizeof(void *));
+    // aligned_alloc vuole una dimensione multipla dell'allineamento
+    void *memory = aligned_alloc(align, (max<size_t>(size, 1) + align - 1) / align * align);
+    if (memory == nullptr)
+    {
+        throw bad_alloc();
+    }
+    return memory;
+}
+
+void *operator new[](size_t size, align_val_t alignment)
+{
+    return operator new(size, alignment);
+}
+
+void operator delete(void *memory, align_val_t) noexcept
+{
+    free(memory);
+}
+
+void operator delete[](void *memory, align_val_t) noexcept
+{
+    free(memory);
+}
+
+void operator delete(void *memory, size_t, align_val_t) noexcept
+{
+    free(memory);
+}
+
+void operator delete[](void *memory, size_t, align_val_t) noexcept
+{
+    free(memory);
+}
+#endif
+
+void QueryStats::addPhase(const char *name, uint64_t nanoseconds)
+{
+    for (PhaseTime &phase : this->phases)
+    {
+        if (strcmp(phase.name, name) == 0)
+        {
+            phase.nanoseconds += nanoseconds;
+            phase.calls++;
+            return;
+        }
+    }
+    this->phases.push_back({name, nanoseconds, 1});
+}
+
+string QueryStats::json() const
+{
+    string text = "{\"queries\":" + to_string(this->queries) +
+                  ",\"contactsScanned\":" + to_string(this->contactsScanned) +
+                  ",\"relaxations\":" + to_string(this->relaxations) +
+                  ",\"treeUpdates\":" + to_string(this->treeUpdates) +
+                  ",\"allocations\":" + to_string(this->allocations) +
+                  ",\"phases\":{";
+    for (size_t i = 0; i < this->phases.size(); i++)
+    {
+        // i nomi delle fasi sono letterali del codice: niente caratteri da escludere
+        text += (i == 0 ? "\"" : ",\"") + string(this->phases[i].name) + "\":{\"ns\":" +
+                to_string(this->phases[i].nanoseconds) + ",\"calls\":" + to_string(this->phases[i].calls) + "}";
+    }
+    return text + "}}";
+}
+
+QueryStats &currentQueryStats()
+{
+    static thread_local QueryStats stats;
+    return stats;
+}
+
+QueryStats queryStats()
+{
+    // la copia delle fasi alloca: si conta prima
+    uint64_t allocations = allocationCount - allocationBase;
+    QueryStats stats = currentQueryStats();
+    stats.allocations = allocations;
+    return stats;
+}
+
+void resetQueryStats()
+{
+    QueryStats &stats = currentQueryStats();
+    stats.queries = 0;
+    stats.contactsScanned = 0;
+    stats.relaxations = 0;
+    stats.treeUpdates = 0;
+    stats.phases.clear();
+    allocationBase = allocationCount;
+}
+
+void dumpQueryStats(const string &path)
+{
+    ofstream file(path, ios::app);
+    if (!file)
+    {
+        throw runtime_error("impossibile aprire il file " + path);
+    }
+    file << queryStats().json() << "\n";
+}
+
+PhaseTimer::PhaseTimer(const char *name)
+{
+    this->name = name;
+    this->start = chrono::steady_clock::now();
+}
+
+PhaseTimer::~PhaseTimer()
+{
+    auto elapsed = chrono::steady_clock::now() - this->start;
+    currentQueryStats().addPhase(this->name, chrono::duration_cast<chrono::nanoseconds>(elapsed).count());
+}
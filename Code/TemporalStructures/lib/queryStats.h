@@ -0,0 +1,84 @@
+#ifndef QUERYSTATS_H
+#define QUERYSTATS_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Strumentazione delle query, attiva solo compilando con TEMPORAL_INSTRUMENTATION
+// (opzione CMake omonima). Senza l'opzione le macro non generano codice e le statistiche
+// restano a zero. I contatori sono per thread: si azzerano con resetQueryStats prima
+// della query e si leggono con queryStats al termine. Il lavoro svolto dai worker di un
+// ThreadPool (matrici, indice di raggiungibilita', connettivita', spanner) resta nei
+// contatori dei worker e non compare in queryStats del thread chiamante: per quelle query
+// le statistiche del chiamante coprono solo la parte sequenziale.
+
+// Tempo cumulato di una fase, in nanosecondi di orologio a parete
+struct PhaseTime
+{
+    // letterale passato a TEMPORAL_PHASE: niente allocazioni durante la misura
+    const char *name;
+    uint64_t nanoseconds = 0;
+    uint64_t calls = 0;
+};
+
+struct QueryStats
+{
+    // query eseguite (scansioni, edgeStream, algoritmi a finestra)
+    uint64_t queries = 0;
+    // contatti del flusso esaminati
+    uint64_t contactsScanned = 0;
+    // rilassamenti riusciti: il valore della testa e' migliorato
+    uint64_t relaxations = 0;
+    // padri assegnati negli alberi e coppie inserite nelle finestre
+    uint64_t treeUpdates = 0;
+    // chiamate a operator new del thread, anche con allineamento esteso
+    uint64_t allocations = 0;
+    vector<PhaseTime> phases;
+
+    void addPhase(const char *name, uint64_t nanoseconds);
+    // oggetto JSON su una riga, con le fasi come oggetto nome -> {ns, calls}
+    string json() const;
+};
+
+#ifdef TEMPORAL_INSTRUMENTATION
+const bool QUERY_STATS_ENABLED = true;
+#else
+const bool QUERY_STATS_ENABLED = false;
+#endif
+
+// contatori del thread corrente, usati dalle macro
+QueryStats &currentQueryStats();
+
+// copia delle statistiche del thread dall'ultimo azzeramento
+QueryStats queryStats();
+void resetQueryStats();
+// accoda queryStats().json() come riga al file path; runtime_error se non si apre
+void dumpQueryStats(const string &path);
+
+// Misura la durata del proprio ambito e la somma alla fase name
+class PhaseTimer
+{
+
+public:
+    const char *name;
+    chrono::steady_clock::time_point start;
+
+    explicit PhaseTimer(const char *name);
+    ~PhaseTimer();
+};
+
+#ifdef TEMPORAL_INSTRUMENTATION
+#define TEMPORAL_COUNT(counter, amount) (currentQueryStats().counter += (amount))
+#define TEMPORAL_PHASE_JOIN(name, line) name##line
+#define TEMPORAL_PHASE_TIMER(line) TEMPORAL_PHASE_JOIN(phaseTimer, line)
+#define TEMPORAL_PHASE(name) PhaseTimer TEMPORAL_PHASE_TIMER(__LINE__)(name)
+#else
+#define TEMPORAL_COUNT(counter, amount) ((void)0)
+#define TEMPORAL_PHASE(name) ((void)0)
+#endif
+
+#endif
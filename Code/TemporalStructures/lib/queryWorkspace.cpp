@@ -0,0 +1,130 @@
+#include "queryWorkspace.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <new>
+
+using namespace std;
+
+QueryArena::QueryArena(size_t initialBytes)
+{
+    this->buffer.resize((initialBytes + sizeof(max_align_t) - 1) / sizeof(max_align_t));
+}
+
+QueryArena::~QueryArena()
+{
+    this->releaseOverflow();
+}
+
+size_t QueryArena::capacity() const
+{
+    return this->buffer.size() * sizeof(max_align_t);
+}
+
+size_t QueryArena::used() const
+{
+    return this->offset + this->overflowBytes;
+}
+
+void *QueryArena::do_allocate(size_t bytes, size_t alignment)
+{
+    // si allinea l'indirizzo e non lo scostamento: vale anche oltre max_align_t
+    uintptr_t base = reinterpret_cast<uintptr_t>(this->buffer.data());
+    size_t start = ((base + this->offset + alignment - 1) & ~uintptr_t(alignment - 1)) - base;
+    if (start + bytes <= this->capacity())
+    {
+        this->offset = start + bytes;
+        return reinterpret_cast<char *>(base + start);
+    }
+
+    // buffer esaurito: il blocco conta nel picco con il caso peggiore di allineamento
+    void *memory = ::operator new(bytes, align_val_t(alignment));
+    this->overflow.push_back({memory, bytes, alignment});
+    this->overflowBytes += bytes + alignment - 1;
+    return memory;
+}
+
+void QueryArena::do_deallocate(void *, size_t, size_t)
+{
+    // monotona: si libera tutto alla reset
+}
+
+bool QueryArena::do_is_equal(const pmr::memory_resource &other) const noexcept
+{
+    return this == &other;
+}
+
+void QueryArena::releaseOverflow()
+{
+    for (const Overflow &block : this->overflow)
+    {
+        ::operator delete(block.memory, block.bytes, align_val_t(block.alignment));
+    }
+    this->overflow.clear();
+}
+
+void QueryArena::reset()
+{
+    if (!this->overflow.empty())
+    {
+        this->releaseOverflow();
+        // la prossima query con lo stesso picco entra tutta nel buffer
+        size_t wanted = max(2 * this->capacity(), this->used());
+        this->buffer.assign((wanted + sizeof(max_align_t) - 1) / sizeof(max_align_t), max_align_t());
+        this->grows++;
+    }
+    this->offset = 0;
+    this->overflowBytes = 0;
+}
+
+QueryWorkspace::QueryWorkspace(size_t initialBytes)
+    : arena(initialBytes), times(&arena), parent(&arena), parentContact(&arena), stream(&arena), stack(&arena),
+      reached(&arena), scratch(&arena), window(&arena)
+{
+}
+
+// scambio con un vettore vuoto sulla stessa arena: il vettore non punta piu' al buffer
+template <typename Vector>
+static void dropStorage(Vector &vector)
+{
+    Vector(vector.get_allocator()).swap(vector);
+}
+
+void QueryWorkspace::reset()
+{
+    dropStorage(this->times);
+    dropStorage(this->parent);
+    dropStorage(this->parentContact);
+    dropStorage(this->stream);
+    dropStorage(this->stack);
+    dropStorage(this->reached);
+    dropStorage(this->scratch.local);
+    dropStorage(this->scratch.queue);
+    dropStorage(this->window.offsets);
+    dropStorage(this->window.entries);
+    dropStorage(this->window.log);
+    dropStorage(this->window.below);
+    dropStorage(this->window.top);
+    dropStorage(this->window.group);
+    this->arena.reset();
+}
+
+QueryWorkspace &threadWorkspace()
+{
+    static thread_local QueryWorkspace workspace;
+    return workspace;
+}
+
+const WindowResult &windowAlgorithmEa(const TemporalGraph &g, const string &source, QueryWorkspace &workspace)
+{
+    workspace.reset();
+    windowAlgorithmEa(g, source, workspace.window);
+    return workspace.window;
+}
+
+const WindowResult &windowAlgorithmLd(const TemporalGraph &g, const string &source, QueryWorkspace &workspace)
+{
+    workspace.reset();
+    windowAlgorithmLd(g, source, workspace.window);
+    return workspace.window;
+}
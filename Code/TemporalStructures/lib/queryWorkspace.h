@@ -0,0 +1,100 @@
+#ifndef QUERYWORKSPACE_H
+#define QUERYWORKSPACE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+#include "pointToPoint.h"
+#include "windowAlgorithms.h"
+
+using namespace std;
+
+// dimensione iniziale dell'arena di una QueryWorkspace
+const size_t QUERY_ARENA_INITIAL = 1 << 16;
+
+// Arena monotona per lo stato di una query: le allocazioni avanzano un puntatore in un
+// unico buffer e le deallocazioni non fanno nulla. Cio' che non entra nel buffer viene
+// chiesto al heap e restituito alla reset successiva, che allarga il buffer al picco
+// osservato: dopo le prime query ogni query entra nel buffer e reset costa O(1). Anche le
+// richieste con allineamento oltre max_align_t sono servite dal buffer, quindi il buffer
+// cresce solo quando lo spazio finisce.
+class QueryArena : public pmr::memory_resource
+{
+
+public:
+    explicit QueryArena(size_t initialBytes = QUERY_ARENA_INITIAL);
+    ~QueryArena();
+
+    QueryArena(const QueryArena &) = delete;
+    QueryArena &operator=(const QueryArena &) = delete;
+
+    // rende di nuovo disponibile tutto il buffer: la memoria gia' distribuita non e' piu' valida
+    void reset();
+    size_t capacity() const;
+    // byte distribuiti dall'ultima reset, dentro e fuori dal buffer
+    size_t used() const;
+    // reset che hanno dovuto allargare il buffer
+    size_t grows = 0;
+
+private:
+    vector<max_align_t> buffer;
+    size_t offset = 0;
+    size_t overflowBytes = 0;
+    struct Overflow
+    {
+        void *memory;
+        size_t bytes;
+        size_t alignment;
+    };
+    vector<Overflow> overflow;
+
+    void releaseOverflow();
+
+    void *do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void *memory, size_t bytes, size_t alignment) override;
+    bool do_is_equal(const pmr::memory_resource &other) const noexcept override;
+};
+
+// Stato riusabile delle query su TemporalGraph: tutti i vettori prendono memoria dall'arena.
+// Ogni query che riceve la workspace la azzera all'inizio, quindi i risultati che vi
+// lascia restano validi fino alla query successiva sulla stessa workspace.
+// Una workspace non va condivisa tra thread.
+class QueryWorkspace
+{
+
+public:
+    QueryArena arena;
+
+    // earliest arrival o latest departure per vertice
+    pmr::vector<int> times;
+    // alberi: vertice padre (NO_VERTEX se non raggiunto) e contatto padre (NO_CONTACT)
+    pmr::vector<uint32_t> parent;
+    pmr::vector<uint32_t> parentContact;
+    // edgeStream: indici nel flusso dello storage dei contatti selezionati
+    pmr::vector<uint32_t> stream;
+    pmr::vector<uint32_t> stack;
+    pmr::vector<uint8_t> reached;
+
+    GroupScratch scratch;
+    WindowResult window;
+    // fuori dall'arena: la query punto a punto non azzera i suoi buffer tra una query e l'altra
+    PointToPointScratch pointToPoint;
+
+    explicit QueryWorkspace(size_t initialBytes = QUERY_ARENA_INITIAL);
+
+    // svuota tutti i vettori e l'arena in tempo costante
+    void reset();
+};
+
+// Workspace del thread corrente, usata dalle query che restituiscono mappe e alberi:
+// piu' thread possono interrogare lo stesso grafo senza lock finche' nessuno lo modifica
+QueryWorkspace &threadWorkspace();
+
+// Algoritmi a finestra con il risultato in workspace.window
+const WindowResult &windowAlgorithmEa(const TemporalGraph &g, const string &source, QueryWorkspace &workspace);
+const WindowResult &windowAlgorithmLd(const TemporalGraph &g, const string &source, QueryWorkspace &workspace);
+
+#endif
@@ -0,0 +1,313 @@
+#include "reachabilityIndex.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+using namespace std;
+
+bool GraphFingerprint::operator==(const GraphFingerprint &other) const
+{
+    return this->vertexCount == other.vertexCount && this->arcCount == other.arcCount &&
+           this->contactCount == other.contactCount && this->contactHash == other.contactHash;
+}
+
+bool GraphFingerprint::operator!=(const GraphFingerprint &other) const
+{
+    return !(*this == other);
+}
+
+GraphFingerprint graphFingerprint(const TemporalStorage &storage)
+{
+    return {storage.vertexCount(), storage.arcCount(), storage.contacts.size(), storage.contactHash};
+}
+
+bool ReachabilityIndex::covers(uint32_t source, uint32_t target) const
+{
+    if (source >= this->vertexCount || target >= this->vertexCount || this->sourceSlot[source] == NO_VERTEX)
+    {
+        return false;
+    }
+    uint64_t bit = uint64_t(this->sourceSlot[source]) * this->vertexCount + target;
+    return ((this->overflow[bit / 64] >> (bit % 64)) & 1) == 0;
+}
+
+int ReachabilityIndex::earliestArrival(uint32_t source, uint32_t target, int departure) const
+{
+    if (!this->covers(source, target))
+    {
+        throw invalid_argument("coppia non coperta dall'indice di raggiungibilita'");
+    }
+    if (source == target)
+    {
+        return departure;
+    }
+
+    uint64_t slot = this->sourceSlot[source];
+    const uint32_t *row = this->offsets.data() + slot * (this->vertexCount + 1);
+    const IndexEntry *first = this->entries.data() + this->base[slot] + row[target];
+    const IndexEntry *last = this->entries.data() + this->base[slot] + row[target + 1];
+    const IndexEntry *entry = lower_bound(first, last, departure, [](const IndexEntry &entry, int time)
+                                          { return entry.departure < time; });
+    return entry == last ? numeric_limits<int>::max() : entry->arrival;
+}
+
+bool ReachabilityIndex::reaches(uint32_t source, uint32_t target, int departure) const
+{
+    return this->earliestArrival(source, target, departure) != numeric_limits<int>::max();
+}
+
+size_t ReachabilityIndex::memoryBytes() const
+{
+    return this->sources.size() * sizeof(uint32_t) + this->sourceSlot.size() * sizeof(uint32_t) +
+           this->base.size() * sizeof(uint64_t) + this->offsets.size() * sizeof(uint32_t) +
+           this->entries.size() * sizeof(IndexEntry) + this->overflow.size() * sizeof(uint64_t);
+}
+
+void buildReachabilityIndex(const ContactView &view, ThreadPool &pool, JourneyMode mode,
+                            const ReachabilityIndexOptions &options, ReachabilityIndex &index)
+{
+    uint32_t n = view.vertexCount;
+    index.mode = mode;
+    index.vertexCount = n;
+    index.timeStart = options.timeStart;
+    index.timeEnd = options.timeEnd;
+    index.maxEntries = options.maxEntries;
+
+    index.sources.clear();
+    index.sourceSlot.assign(n, NO_VERTEX);
+    for (size_t i = 0; i < (options.sources.empty() ? n : options.sources.size()); i++)
+    {
+        uint32_t source = options.sources.empty() ? uint32_t(i) : options.sources[i];
+        if (source >= n)
+        {
+            throw invalid_argument("sorgente fuori dal grafo: " + to_string(source));
+        }
+        if (index.sourceSlot[source] == NO_VERTEX)
+        {
+            index.sourceSlot[source] = index.sources.size();
+            index.sources.push_back(source);
+        }
+    }
+
+    size_t sourceCount = index.sources.size();
+    index.offsets.assign(sourceCount * (n + 1), 0);
+    index.overflow.assign((sourceCount * n + 63) / 64, 0);
+    ContactView window = timeWindow(view, options.timeStart, options.timeEnd);
+
+    // coppie e destinazioni escluse di ogni sorgente, prima della copia nel buffer unico
+    vector<vector<IndexEntry>> labels(sourceCount);
+    vector<vector<uint32_t>> overflowed(sourceCount);
+    vector<TemporalProfile> profiles(pool.size());
+    pool.parallelFor(sourceCount, [&](size_t slot, unsigned worker)
+                     {
+                         TemporalProfile &profile = profiles[worker];
+                         earliestArrivalProfile(window, index.sources[slot], mode, profile);
+                         uint32_t *row = index.offsets.data() + slot * (n + 1);
+                         vector<IndexEntry> &label = labels[slot];
+                         for (uint32_t v = 0; v < n; v++)
+                         {
+                             uint32_t size = profile.offsets[v + 1] - profile.offsets[v];
+                             if (options.maxEntries != 0 && size > options.maxEntries)
+                             {
+                                 overflowed[slot].push_back(v);
+                             }
+                             else
+                             {
+                                 for (uint32_t i = profile.offsets[v]; i < profile.offsets[v + 1]; i++)
+                                 {
+                                     label.push_back({profile.entries[i].departure, profile.entries[i].arrival});
+                                 }
+                             }
+                             if (label.size() >= NO_CONTACT)
+                             {
+                                 throw runtime_error("troppe coppie per una sorgente dell'indice di raggiungibilita'");
+                             }
+                             row[v + 1] = label.size();
+                         } });
+
+    index.base.assign(sourceCount + 1, 0);
+    for (size_t slot = 0; slot < sourceCount; slot++)
+    {
+        index.base[slot + 1] = index.base[slot] + labels[slot].size();
+        for (uint32_t v : overflowed[slot])
+        {
+            uint64_t bit = uint64_t(slot) * n + v;
+            index.overflow[bit / 64] |= uint64_t(1) << (bit % 64);
+        }
+    }
+    index.entries.resize(index.base[sourceCount]);
+    pool.parallelFor(sourceCount, [&](size_t slot, unsigned)
+                     {
+                         copy(labels[slot].begin(), labels[slot].end(), index.entries.begin() + index.base[slot]);
+                         vector<IndexEntry>().swap(labels[slot]); });
+}
+
+// posizione in byte, dall'inizio del file, di ogni sezione dell'indice
+struct IndexLayout
+{
+    uint64_t sources;  // uint32_t[sourceCount]
+    uint64_t base;     // uint64_t[sourceCount + 1]
+    uint64_t offsets;  // uint32_t[sourceCount * (vertexCount + 1)]
+    uint64_t overflow; // uint64_t[(sourceCount * vertexCount + 63) / 64]
+    uint64_t entries;  // IndexEntry[entryCount]
+    uint64_t size;
+};
+
+static uint64_t alignSection(uint64_t position)
+{
+    return (position + 7) & ~uint64_t(7);
+}
+
+static IndexLayout indexLayout(const IndexHeader &header)
+{
+    IndexLayout layout;
+    uint64_t sources = header.sourceCount;
+    layout.sources = alignSection(sizeof(IndexHeader));
+    layout.base = alignSection(layout.sources + sources * sizeof(uint32_t));
+    layout.offsets = alignSection(layout.base + (sources + 1) * sizeof(uint64_t));
+    layout.overflow = alignSection(layout.offsets + sources * (header.vertexCount + 1) * sizeof(uint32_t));
+    layout.entries = alignSection(layout.overflow + (sources * header.vertexCount + 63) / 64 * sizeof(uint64_t));
+    layout.size = layout.entries + header.entryCount * sizeof(IndexEntry);
+    return layout;
+}
+
+// controlla l'intestazione contro la dimensione del file; i conteggi vengono limitati da
+// fileSize prima di calcolare il layout, cosi' i prodotti e le somme di indexLayout non
+// possono traboccare
+static bool validIndexHeader(const IndexHeader &header, uint64_t fileSize)
+{
+    uint64_t words = fileSize / sizeof(uint32_t);
+    if (fileSize > (uint64_t(1) << 56) || header.entryCount > fileSize / sizeof(IndexEntry) ||
+        header.sourceCount > header.vertexCount || header.vertexCount >= words ||
+        (header.sourceCount > 0 && header.vertexCount + 1 > words / header.sourceCount))
+    {
+        return false;
+    }
+    return memcmp(header.magic, INDEX_MAGIC, sizeof(header.magic)) == 0 && header.version == INDEX_VERSION &&
+           (header.flags & ~INDEX_STRICT) == 0 && header.vertexCount < NO_VERTEX &&
+           indexLayout(header).size == fileSize;
+}
+
+static void writeSection(ofstream &file, uint64_t position, const void *data, size_t bytes)
+{
+    static const char padding[8] = {};
+    uint64_t current = file.tellp();
+    file.write(padding, position - current);
+    file.write(static_cast<const char *>(data), bytes);
+}
+
+template <typename T>
+static void readSection(ifstream &file, uint64_t position, vector<T> &data, uint64_t count)
+{
+    data.resize(count);
+    file.seekg(position);
+    file.read(reinterpret_cast<char *>(data.data()), count * sizeof(T));
+}
+
+void writeReachabilityIndex(const ReachabilityIndex &index, const string &path)
+{
+    IndexHeader header = {};
+    memcpy(header.magic, INDEX_MAGIC, sizeof(header.magic));
+    header.version = INDEX_VERSION;
+    header.flags = index.mode == JourneyMode::Strict ? INDEX_STRICT : 0;
+    header.vertexCount = index.vertexCount;
+    header.sourceCount = index.sources.size();
+    header.entryCount = index.entries.size();
+    header.maxEntries = index.maxEntries;
+    header.timeStart = index.timeStart;
+    header.timeEnd = index.timeEnd;
+    header.graph = index.graph;
+    IndexLayout layout = indexLayout(header);
+
+    ofstream file(path, ios::binary | ios::trunc);
+    if (!file)
+    {
+        throw runtime_error("impossibile scrivere " + path);
+    }
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    writeSection(file, layout.sources, index.sources.data(), index.sources.size() * sizeof(uint32_t));
+    writeSection(file, layout.base, index.base.data(), index.base.size() * sizeof(uint64_t));
+    writeSection(file, layout.offsets, index.offsets.data(), index.offsets.size() * sizeof(uint32_t));
+    writeSection(file, layout.overflow, index.overflow.data(), index.overflow.size() * sizeof(uint64_t));
+    writeSection(file, layout.entries, index.entries.data(), index.entries.size() * sizeof(IndexEntry));
+    if (!file)
+    {
+        throw runtime_error("errore di scrittura su " + path);
+    }
+}
+
+ReachabilityIndex readReachabilityIndex(const string &path)
+{
+    ifstream file(path, ios::binary | ios::ate);
+    if (!file)
+    {
+        throw runtime_error("impossibile aprire " + path);
+    }
+    uint64_t fileSize = file.tellg();
+    file.seekg(0);
+
+    IndexHeader header;
+    file.read(reinterpret_cast<char *>(&header), sizeof(header));
+    if (!file || !validIndexHeader(header, fileSize))
+    {
+        throw runtime_error(path + " non e' un indice di raggiungibilita' valido");
+    }
+    IndexLayout layout = indexLayout(header);
+    uint64_t n = header.vertexCount;
+
+    ReachabilityIndex index;
+    index.mode = (header.flags & INDEX_STRICT) != 0 ? JourneyMode::Strict : JourneyMode::NonStrict;
+    index.vertexCount = n;
+    index.timeStart = header.timeStart;
+    index.timeEnd = header.timeEnd;
+    index.maxEntries = header.maxEntries;
+    index.graph = header.graph;
+    readSection(file, layout.sources, index.sources, header.sourceCount);
+    readSection(file, layout.base, index.base, header.sourceCount + 1);
+    readSection(file, layout.offsets, index.offsets, header.sourceCount * (n + 1));
+    readSection(file, layout.overflow, index.overflow, (header.sourceCount * n + 63) / 64);
+    readSection(file, layout.entries, index.entries, header.entryCount);
+    if (!file)
+    {
+        throw runtime_error("errore di lettura da " + path);
+    }
+
+    // le query si fidano di base e offsets, e cercano la partenza con una ricerca binaria: un
+    // file rovinato non deve portarle fuori da entries ne' presentare profili non ordinati
+    index.sourceSlot.assign(n, NO_VERTEX);
+    bool valid = index.base[0] == 0 && index.base[header.sourceCount] == header.entryCount;
+    for (size_t slot = 0; valid && slot < index.sources.size(); slot++)
+    {
+        valid = index.base[slot] <= index.base[slot + 1];
+    }
+    for (size_t slot = 0; valid && slot < index.sources.size(); slot++)
+    {
+        valid = index.sources[slot] < n && index.sourceSlot[index.sources[slot]] == NO_VERTEX;
+        const uint32_t *row = index.offsets.data() + slot * (n + 1);
+        valid = valid && row[0] == 0 && row[n] == index.base[slot + 1] - index.base[slot];
+        for (uint64_t v = 0; valid && v < n; v++)
+        {
+            valid = row[v] <= row[v + 1];
+        }
+        // base e la riga sono validi: il profilo e' dentro entries
+        const IndexEntry *profile = index.entries.data() + index.base[slot];
+        for (uint64_t v = 0; valid && v < n; v++)
+        {
+            for (uint32_t e = row[v] + 1; valid && e < row[v + 1]; e++)
+            {
+                valid = profile[e - 1].departure <= profile[e].departure;
+            }
+        }
+        if (valid)
+        {
+            index.sourceSlot[index.sources[slot]] = slot;
+        }
+    }
+    if (!valid)
+    {
+        throw runtime_error(path + " non e' un indice di raggiungibilita' valido");
+    }
+    return index;
+}
@@ -0,0 +1,120 @@
+#ifndef REACHABILITYINDEX_H
+#define REACHABILITYINDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "temporalProfiles.h"
+#include "threadPool.h"
+
+using namespace std;
+
+// Parametri dell'indice: spazio e tempo di costruzione crescono con il numero di sorgenti,
+// con l'ampiezza della finestra e con maxEntries. Le coppie escluse non sono coperte
+// dall'indice e vanno risolte con una scansione (TemporalGraph::earliestArrival lo fa).
+struct ReachabilityIndexOptions
+{
+    // sorgenti indicizzate; vuoto = tutti i vertici
+    vector<uint32_t> sources;
+    // solo i viaggi con tutti i contatti in [timeStart, timeEnd]
+    int timeStart = numeric_limits<int>::min();
+    int timeEnd = numeric_limits<int>::max();
+    // le coppie con un profilo piu' lungo non vengono memorizzate (0 = nessun limite)
+    size_t maxEntries = 0;
+};
+
+// Grafo da cui e' stato costruito un indice: un indice vale solo per lo stesso grafo,
+// non modificato, e le query lo controllano in tempo costante
+struct GraphFingerprint
+{
+    uint64_t vertexCount = 0;
+    uint64_t arcCount = 0;
+    uint64_t contactCount = 0;
+    uint64_t contactHash = 0;
+
+    bool operator==(const GraphFingerprint &other) const;
+    bool operator!=(const GraphFingerprint &other) const;
+};
+
+GraphFingerprint graphFingerprint(const TemporalStorage &storage);
+
+// Coppia (partenza dalla sorgente, arrivo nella destinazione) di un profilo
+struct IndexEntry
+{
+    int departure;
+    int arrival;
+};
+
+// Chiusura transitiva temporale per intervalli: per ogni sorgente indicizzata s e ogni
+// vertice v, il profilo di earliest arrival da s a v (insieme di Pareto delle coppie
+// partenza/arrivo, crescenti in entrambe). L'earliest arrival da s a v partendo non
+// prima di t e' l'arrivo della prima coppia con partenza >= t: una ricerca binaria.
+// Le coppie della sorgente slot stanno in entries[base[slot] + offsets[slot * (n + 1) + v] ..
+// base[slot] + offsets[slot * (n + 1) + v + 1]), con n = vertexCount.
+class ReachabilityIndex
+{
+
+public:
+    JourneyMode mode = JourneyMode::NonStrict;
+    uint32_t vertexCount = 0;
+    int timeStart = numeric_limits<int>::min();
+    int timeEnd = numeric_limits<int>::max();
+    size_t maxEntries = 0;
+    // grafo di origine, impostato da TemporalGraph::reachabilityIndex e salvato nel file
+    GraphFingerprint graph;
+
+    vector<uint32_t> sources;
+    // slot di ogni vertice in sources, NO_VERTEX se non e' una sorgente indicizzata
+    vector<uint32_t> sourceSlot;
+    vector<uint64_t> base;
+    vector<uint32_t> offsets;
+    vector<IndexEntry> entries;
+    // bit slot * n + v acceso se il profilo da sources[slot] a v superava maxEntries
+    vector<uint64_t> overflow;
+
+    // la coppia e' risolta dall'indice
+    bool covers(uint32_t source, uint32_t target) const;
+    // earliest arrival in target partendo da source non prima di departure (departure se
+    // coincidono, INT_MAX se irraggiungibile); invalid_argument se la coppia non e' coperta
+    int earliestArrival(uint32_t source, uint32_t target, int departure) const;
+    bool reaches(uint32_t source, uint32_t target, int departure) const;
+
+    size_t memoryBytes() const;
+};
+
+// Costruisce l'indice sulla vista distribuendo le sorgenti sul pool: ogni worker calcola i
+// profili con un proprio TemporalProfile, poi le coppie vengono copiate in parallelo nel
+// buffer unico.
+void buildReachabilityIndex(const ContactView &view, ThreadPool &pool, JourneyMode mode,
+                            const ReachabilityIndexOptions &options, ReachabilityIndex &index);
+
+// File binario dell'indice: intestazione e sezioni allineate a 8 byte, come gli snapshot.
+// I valori sono nell'ordine dei byte della macchina che ha scritto il file.
+const char INDEX_MAGIC[8] = {'T', 'G', 'R', 'I', 'D', 'X', '\0', '\0'};
+const uint32_t INDEX_VERSION = 2;
+
+// bit di IndexHeader::flags
+const uint32_t INDEX_STRICT = 1;
+
+struct IndexHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t flags; // INDEX_STRICT; gli altri bit sono riservati e valgono 0
+    uint64_t vertexCount;
+    uint64_t sourceCount;
+    uint64_t entryCount;
+    uint64_t maxEntries;
+    int64_t timeStart;
+    int64_t timeEnd;
+    GraphFingerprint graph;
+};
+
+// Lancia runtime_error se il file non si apre o non e' un indice valido
+void writeReachabilityIndex(const ReachabilityIndex &index, const string &path);
+ReachabilityIndex readReachabilityIndex(const string &path);
+
+#endif
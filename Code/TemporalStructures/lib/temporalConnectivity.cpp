@@ -0,0 +1,228 @@
+#include "temporalConnectivity.h"
+
+#include <algorithm>
+#include <atomic>
+
+using namespace std;
+
+// Buffer di un worker, riusati da un blocco all'altro
+struct ConnectivityScratch
+{
+    vector<uint64_t> reach;
+    vector<pair<uint32_t, uint64_t>> pending;
+    GroupScratch group;
+};
+
+// Dati del controllo condivisi in sola lettura dai blocchi
+struct ConnectivityCheck
+{
+    const ContactView &view;
+    const vector<uint32_t> &vertices;
+    JourneyMode mode;
+    vector<uint8_t> active;
+    // vertici attivi in ordine di ultimo contatto entrante (quelli senza contatti entranti per primi)
+    vector<uint32_t> order;
+    vector<size_t> lastIncoming;
+};
+
+static ConnectivityCheck prepareCheck(const ContactView &view, const vector<uint32_t> &vertices, JourneyMode mode)
+{
+    ConnectivityCheck check{view, vertices, mode, {}, {}, {}};
+    check.active.assign(view.vertexCount, 0);
+    for (uint32_t v : vertices)
+    {
+        check.active[v] = 1;
+    }
+
+    // 0 = nessun contatto entrante, altrimenti indice dell'ultimo contatto entrante + 1
+    check.lastIncoming.assign(view.vertexCount, 0);
+    for (size_t i = view.first; i < view.last; i++)
+    {
+        const Contact &contact = view.contacts[i];
+        check.lastIncoming[contact.to] = i + 1;
+        if (view.undirected)
+        {
+            check.lastIncoming[contact.from] = i + 1;
+        }
+    }
+    for (uint32_t v = 0; v < view.vertexCount; v++)
+    {
+        if (check.active[v])
+        {
+            check.order.push_back(v);
+        }
+    }
+    sort(check.order.begin(), check.order.end(), [&check](uint32_t a, uint32_t b)
+         { return check.lastIncoming[a] < check.lastIncoming[b]; });
+    return check;
+}
+
+// Controlla il blocco di sorgenti [first, first + count) di vertices; restituisce false con
+// la testimone se una coppia non e' raggiungibile. stop viene consultato a ogni gruppo di
+// contatti simultanei: se vale true il blocco si interrompe (il risultato non conta).
+template <typename Stop>
+static bool checkBlock(const ConnectivityCheck &check, size_t first, size_t count, ConnectivityScratch &scratch,
+                       ConnectivityWitness &witness, Stop stop)
+{
+    const ContactView &view = check.view;
+    uint64_t full = count == 64 ? ~uint64_t(0) : (uint64_t(1) << count) - 1;
+    vector<uint64_t> &reach = scratch.reach;
+    reach.assign(view.vertexCount, 0);
+    for (size_t k = 0; k < count; k++)
+    {
+        reach[check.vertices[first + k]] |= uint64_t(1) << k;
+    }
+
+    size_t fullCount = 0;
+    for (uint32_t v : check.order)
+    {
+        fullCount += reach[v] == full;
+    }
+    auto update = [&](uint32_t head, uint64_t mask)
+    {
+        uint64_t before = reach[head];
+        reach[head] |= mask;
+        if (check.active[head] && before != full && reach[head] == full)
+        {
+            fullCount++;
+        }
+    };
+
+    // i vertici che hanno superato l'ultimo contatto entrante non cambiano piu'
+    size_t settled = 0;
+    auto proveMissing = [&](size_t position)
+    {
+        for (; settled < check.order.size() && check.lastIncoming[check.order[settled]] <= position; settled++)
+        {
+            uint32_t v = check.order[settled];
+            if (reach[v] != full)
+            {
+                witness.source = check.vertices[first + __builtin_ctzll(full & ~reach[v])];
+                witness.target = v;
+                return true;
+            }
+        }
+        return false;
+    };
+
+    if (proveMissing(view.first))
+    {
+        return false;
+    }
+
+    bool strict = check.mode == JourneyMode::Strict;
+    auto relax = [&](size_t, uint32_t tail, uint32_t head)
+    {
+        uint64_t mask = reach[tail] & ~reach[head];
+        if (mask == 0)
+        {
+            return false;
+        }
+        update(head, mask);
+        return true;
+    };
+
+    for (size_t groupFirst = view.first; groupFirst < view.last && fullCount < check.order.size();)
+    {
+        if (stop())
+        {
+            return true;
+        }
+        size_t groupLast = groupFirst + 1;
+        while (groupLast < view.last && view.contacts[groupLast].time == view.contacts[groupFirst].time)
+        {
+            groupLast++;
+        }
+
+        if (strict)
+        {
+            // nel gruppo valgono gli insiemi raggiunti prima del gruppo: si applicano alla fine
+            scratch.pending.clear();
+            for (size_t i = groupFirst; i < groupLast; i++)
+            {
+                const Contact &contact = view.contacts[i];
+                scratch.pending.push_back({contact.to, reach[contact.from]});
+                if (view.undirected)
+                {
+                    scratch.pending.push_back({contact.from, reach[contact.to]});
+                }
+            }
+            for (auto [head, mask] : scratch.pending)
+            {
+                update(head, mask);
+            }
+        }
+        else
+        {
+            scratch.group.queue.clear();
+            for (size_t i = groupFirst; i < groupLast; i++)
+            {
+                const Contact &contact = view.contacts[i];
+                if (relax(i, contact.from, contact.to))
+                {
+                    scratch.group.queue.push_back({contact.to, (uint32_t)i});
+                }
+                if (view.undirected && relax(i, contact.to, contact.from))
+                {
+                    scratch.group.queue.push_back({contact.from, (uint32_t)i});
+                }
+            }
+            if (!scratch.group.queue.empty() && groupLast - groupFirst > 1)
+            {
+                propagateTimeGroup(view, groupFirst, groupLast, true, scratch.group, relax);
+            }
+        }
+        TEMPORAL_COUNT(contactsScanned, groupLast - groupFirst);
+
+        if (proveMissing(groupLast))
+        {
+            return false;
+        }
+        groupFirst = groupLast;
+    }
+    // flusso finito: ogni vertice ha superato il suo ultimo contatto entrante
+    return !proveMissing(view.last);
+}
+
+bool temporallyConnected(const ContactView &view, const vector<uint32_t> &vertices, ThreadPool &pool,
+                         JourneyMode mode, ConnectivityWitness *witness)
+{
+    TEMPORAL_PHASE("temporallyConnected");
+    TEMPORAL_COUNT(queries, 1);
+    ConnectivityCheck check = prepareCheck(view, vertices, mode);
+    size_t blocks = (vertices.size() + CONNECTIVITY_BLOCK - 1) / CONNECTIVITY_BLOCK;
+
+    vector<ConnectivityScratch> scratches(pool.size());
+    vector<ConnectivityWitness> witnesses(blocks);
+    // primo blocco fallito: i blocchi successivi possono fermarsi
+    atomic<size_t> firstFailed(blocks);
+    pool.parallelFor(blocks, [&](size_t block, unsigned worker)
+                     {
+                         auto stop = [&firstFailed, block]()
+                         {
+                             return firstFailed.load(memory_order_relaxed) < block;
+                         };
+                         if (stop())
+                         {
+                             return;
+                         }
+                         size_t first = block * CONNECTIVITY_BLOCK;
+                         size_t count = min(CONNECTIVITY_BLOCK, vertices.size() - first);
+                         if (!checkBlock(check, first, count, scratches[worker], witnesses[block], stop))
+                         {
+                             size_t current = firstFailed.load();
+                             while (block < current && !firstFailed.compare_exchange_weak(current, block))
+                             {
+                             }
+                         } });
+
+    if (firstFailed.load() == blocks)
+    {
+        return true;
+    }
+    if (witness != nullptr)
+    {
+        *witness = witnesses[firstFailed.load()];
+    }
+    return false;
+}
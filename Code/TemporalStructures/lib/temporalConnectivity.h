@@ -0,0 +1,34 @@
+#ifndef TEMPORALCONNECTIVITY_H
+#define TEMPORALCONNECTIVITY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "temporalScan.h"
+#include "threadPool.h"
+
+using namespace std;
+
+// numero di sorgenti di un blocco: una parola di bit per vertice
+const size_t CONNECTIVITY_BLOCK = 64;
+
+// Prima coppia trovata per cui target non e' raggiungibile da source
+struct ConnectivityWitness
+{
+    uint32_t source = NO_VERTEX;
+    uint32_t target = NO_VERTEX;
+};
+
+// Verifica che ogni vertice di vertices raggiunga temporalmente tutti gli altri nella vista.
+// Le sorgenti si elaborano a blocchi di CONNECTIVITY_BLOCK, distribuiti sul pool: ogni
+// blocco scorre il flusso una volta sola con, per ogni vertice, la parola delle sorgenti
+// del blocco che lo hanno raggiunto. Un blocco si ferma appena tutti i suoi bit sono
+// accesi su tutti i vertici, oppure appena un vertice ha superato l'ultimo contatto che
+// entra in lui senza essere stato raggiunto da qualche sorgente: quella coppia e' la
+// testimone. Trovato un blocco che fallisce, i blocchi successivi vengono interrotti e la
+// testimone riportata e' quella del primo blocco che fallisce.
+bool temporallyConnected(const ContactView &view, const vector<uint32_t> &vertices, ThreadPool &pool,
+                         JourneyMode mode, ConnectivityWitness *witness = nullptr);
+
+#endif
@@ -0,0 +1,137 @@
+#include "temporalGraphView.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+TemporalGraphView::TemporalGraphView(const string &path, bool validate)
+{
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        throw runtime_error("impossibile aprire " + path);
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(SnapshotHeader))
+    {
+        close(fd);
+        throw runtime_error(path + " non e' uno snapshot valido");
+    }
+
+    // la mappatura resta valida anche dopo la chiusura del descrittore
+    this->mappingSize = info.st_size;
+    this->mapping = mmap(nullptr, this->mappingSize, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (this->mapping == MAP_FAILED)
+    {
+        throw runtime_error("impossibile mappare " + path);
+    }
+
+    const char *base = static_cast<const char *>(this->mapping);
+    memcpy(&this->header, base, sizeof(SnapshotHeader));
+    if (!validSnapshot(this->header, this->mappingSize))
+    {
+        munmap(this->mapping, this->mappingSize);
+        throw runtime_error(path + " non e' uno snapshot valido");
+    }
+
+    SnapshotLayout layout = snapshotLayout(this->header);
+    this->nameOffsets = reinterpret_cast<const uint64_t *>(base + layout.nameOffsets);
+    this->nameChars = base + layout.nameChars;
+    this->nameIndex = reinterpret_cast<const uint32_t *>(base + layout.nameIndex);
+    this->alive = reinterpret_cast<const uint8_t *>(base + layout.alive);
+    this->offsets = reinterpret_cast<const uint32_t *>(base + layout.offsets);
+    this->neighbours = reinterpret_cast<const uint32_t *>(base + layout.neighbours);
+    this->timeOffsets = reinterpret_cast<const uint32_t *>(base + layout.timeOffsets);
+    this->timestamps = reinterpret_cast<const int *>(base + layout.timestamps);
+    this->contacts = reinterpret_cast<const Contact *>(base + layout.contacts);
+
+    if (!validate)
+    {
+        return;
+    }
+    SnapshotSections sections = {this->nameOffsets, this->nameChars, this->nameIndex, this->offsets,
+                                 this->neighbours, this->timeOffsets, this->contacts};
+    if (!validSnapshotSections(this->header, sections))
+    {
+        munmap(this->mapping, this->mappingSize);
+        throw runtime_error(path + " non e' uno snapshot valido");
+    }
+}
+
+TemporalGraphView::~TemporalGraphView()
+{
+    munmap(this->mapping, this->mappingSize);
+}
+
+bool TemporalGraphView::directed() const
+{
+    return (this->header.flags & SNAPSHOT_UNDIRECTED) == 0;
+}
+
+uint32_t TemporalGraphView::vertexCount() const
+{
+    return this->header.vertexCount;
+}
+
+size_t TemporalGraphView::arcCount() const
+{
+    return this->header.arcCount;
+}
+
+size_t TemporalGraphView::contactCount() const
+{
+    return this->header.contactCount;
+}
+
+bool TemporalGraphView::isAlive(uint32_t vertex) const
+{
+    return vertex < this->vertexCount() && this->alive[vertex];
+}
+
+string_view TemporalGraphView::name(uint32_t id) const
+{
+    return string_view(this->nameChars + this->nameOffsets[id], this->nameOffsets[id + 1] - this->nameOffsets[id]);
+}
+
+uint32_t TemporalGraphView::find(string_view name) const
+{
+    const uint32_t *begin = this->nameIndex;
+    const uint32_t *end = this->nameIndex + this->vertexCount();
+    const uint32_t *found = lower_bound(begin, end, name, [this](uint32_t id, string_view key)
+                                        { return this->name(id) < key; });
+    if (found == end || this->name(*found) != name)
+    {
+        return NO_VERTEX;
+    }
+    return *found;
+}
+
+uint32_t TemporalGraphView::findArc(uint32_t start, uint32_t end) const
+{
+    if (!this->directed() && start > end)
+    {
+        swap(start, end);
+    }
+    const uint32_t *rowBegin = this->neighbours + this->offsets[start];
+    const uint32_t *rowEnd = this->neighbours + this->offsets[start + 1];
+    const uint32_t *found = lower_bound(rowBegin, rowEnd, end);
+    if (found == rowEnd || *found != end)
+    {
+        return NO_ARC;
+    }
+    return found - this->neighbours;
+}
+
+ContactView TemporalGraphView::contactView() const
+{
+    return {this->contacts, 0, this->contactCount(), this->vertexCount(), !this->directed()};
+}
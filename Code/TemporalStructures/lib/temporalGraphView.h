@@ -0,0 +1,68 @@
+#ifndef TEMPORALGRAPHVIEW_H
+#define TEMPORALGRAPHVIEW_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "temporalLoader.h"
+#include "temporalScan.h"
+
+using namespace std;
+
+// Grafo temporale in sola lettura sopra uno snapshot mappato in memoria (writeSnapshot).
+// All'apertura si legge solo l'intestazione: tutti gli array puntano direttamente alle
+// pagine del file, condivise tramite la page cache tra i processi che aprono lo stesso
+// snapshot. contactView() restituisce una ContactView sul flusso del file, quindi le
+// query EA/LD, a finestra, di viaggio e di profilo girano sulla vista senza copie;
+// gli id sono gli stessi del TemporalStorage salvato.
+// Senza validate le sezioni non vengono controllate: il file deve essere affidabile
+// (scritto da writeSnapshot o gia' verificato una volta, per esempio aprendolo con
+// validate), altrimenti gli accessori possono leggere fuori dalla mappatura. Con validate
+// si esegue validSnapshotSections, una passata su tutto il file. In ogni caso il file non
+// va modificato ne' troncato finche' la vista e' aperta, perche' la mappatura e' condivisa.
+class TemporalGraphView
+{
+
+public:
+    SnapshotHeader header;
+
+    const uint64_t *nameOffsets;
+    const char *nameChars;
+    const uint32_t *nameIndex;
+    const uint8_t *alive;
+
+    const uint32_t *offsets;
+    const uint32_t *neighbours;
+    const uint32_t *timeOffsets;
+    const int *timestamps;
+    const Contact *contacts;
+
+    // Lancia runtime_error se il file non si apre o non e' uno snapshot valido (con
+    // validate anche se una sezione e' danneggiata)
+    explicit TemporalGraphView(const string &path, bool validate = false);
+    ~TemporalGraphView();
+
+    TemporalGraphView(const TemporalGraphView &) = delete;
+    TemporalGraphView &operator=(const TemporalGraphView &) = delete;
+
+    bool directed() const;
+    uint32_t vertexCount() const;
+    size_t arcCount() const;
+    size_t contactCount() const;
+    bool isAlive(uint32_t vertex) const;
+
+    string_view name(uint32_t id) const;
+    // ricerca binaria sull'indice dei nomi; NO_VERTEX se il nome non c'e'
+    uint32_t find(string_view name) const;
+
+    uint32_t findArc(uint32_t start, uint32_t end) const;
+    ContactView contactView() const;
+
+private:
+    void *mapping;
+    size_t mappingSize;
+};
+
+#endif
@@ -0,0 +1,111 @@
+#include "temporalJourneys.h"
+
+using namespace std;
+
+void fastestJourneyScan(const ContactView &view, uint32_t source, JourneyMode mode,
+                        vector<int64_t> &duration, vector<uint32_t> *parentContact)
+{
+    duration.assign(view.vertexCount, numeric_limits<int64_t>::max());
+    if (parentContact != nullptr)
+    {
+        parentContact->assign(view.vertexCount, NO_CONTACT);
+    }
+    if (source == NO_VERTEX)
+    {
+        return;
+    }
+    duration[source] = 0;
+
+    bool strict = mode == JourneyMode::Strict;
+    vector<ParetoEntry> entries;
+    vector<uint32_t> top(view.vertexCount, NO_CONTACT);
+
+    auto relax = [&](size_t i, uint32_t tail, uint32_t head)
+    {
+        int time = view.contacts[i].time;
+        if (head == source)
+        {
+            return false;
+        }
+
+        // dalla sorgente conviene sempre partire con questo stesso contatto
+        int start = time;
+        if (tail != source)
+        {
+            uint32_t entry = paretoUsable(entries, top, tail, time, strict);
+            if (entry == NO_CONTACT)
+            {
+                return false;
+            }
+            start = entries[entry].key;
+        }
+
+        if (!paretoPush(entries, top, head, start, time, i, [](int key, int other)
+                       { return key > other; }))
+        {
+            return false;
+        }
+        if ((int64_t)time - start < duration[head])
+        {
+            duration[head] = (int64_t)time - start;
+            if (parentContact != nullptr)
+            {
+                (*parentContact)[head] = i;
+            }
+        }
+        return true;
+    };
+
+    GroupScratch scratch;
+    scanTimeGroups(view, true, mode, scratch, relax);
+}
+
+void shortestJourneyScan(const ContactView &view, uint32_t source, JourneyMode mode,
+                         vector<int> &hops, vector<uint32_t> *parentContact)
+{
+    hops.assign(view.vertexCount, numeric_limits<int>::max());
+    if (parentContact != nullptr)
+    {
+        parentContact->assign(view.vertexCount, NO_CONTACT);
+    }
+    if (source == NO_VERTEX)
+    {
+        return;
+    }
+
+    bool strict = mode == JourneyMode::Strict;
+    vector<ParetoEntry> entries = {{0, numeric_limits<int>::min(), NO_CONTACT, NO_CONTACT}};
+    vector<uint32_t> top(view.vertexCount, NO_CONTACT);
+    top[source] = 0;
+    hops[source] = 0;
+
+    auto relax = [&](size_t i, uint32_t tail, uint32_t head)
+    {
+        int time = view.contacts[i].time;
+        uint32_t entry = paretoUsable(entries, top, tail, time, strict);
+        if (entry == NO_CONTACT)
+        {
+            return false;
+        }
+
+        int count = entries[entry].key + 1;
+        if (!paretoPush(entries, top, head, count, time, i, [](int key, int other)
+                       { return key < other; }))
+        {
+            return false;
+        }
+        // la cima della pila ha sempre il minor numero di salti
+        if (count < hops[head])
+        {
+            hops[head] = count;
+            if (parentContact != nullptr)
+            {
+                (*parentContact)[head] = i;
+            }
+        }
+        return true;
+    };
+
+    GroupScratch scratch;
+    scanTimeGroups(view, true, mode, scratch, relax);
+}
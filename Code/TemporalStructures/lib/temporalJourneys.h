@@ -0,0 +1,74 @@
+#ifndef TEMPORALJOURNEYS_H
+#define TEMPORALJOURNEYS_H
+
+#include <cstdint>
+#include <vector>
+
+#include "temporalScan.h"
+
+using namespace std;
+
+// Elemento di una lista di Pareto per vertice. time e' l'istante del contatto che l'ha
+// generato; key e' l'altro criterio: l'istante di partenza dalla sorgente per il viaggio piu'
+// veloce, il numero di contatti per il piu' corto, l'arrivo alla destinazione per il profilo
+// di latest departure. Le liste sono pile nel registro comune: prev e' l'elemento
+// sottostante dello stesso vertice.
+struct ParetoEntry
+{
+    int key;
+    int time;
+    uint32_t prev;
+    uint32_t contact;
+};
+
+// Elemento della pila di vertex utilizzabile da un contatto al tempo time. Il flusso e'
+// scandito in ordine, quindi tutti gli elementi stanno gia' dal lato giusto di time e gli
+// istanti sono distinti: solo in modalita' stretta, se la cima ha proprio istante time,
+// si scende di un elemento.
+inline uint32_t paretoUsable(const vector<ParetoEntry> &entries, const vector<uint32_t> &top, uint32_t vertex,
+                             int time, bool strict)
+{
+    uint32_t entry = top[vertex];
+    if (strict && entry != NO_CONTACT && entries[entry].time == time)
+    {
+        entry = entries[entry].prev;
+    }
+    return entry;
+}
+
+// Inserisce la coppia (key, time) in cima alla pila di vertex se non e' dominata.
+// Se la chiave della cima non e' peggiore la nuova coppia e' dominata; se la cima ha lo
+// stesso istante viene sostituita.
+template <typename Better>
+bool paretoPush(vector<ParetoEntry> &entries, vector<uint32_t> &top, uint32_t vertex, int key, int time,
+                uint32_t contact, Better better)
+{
+    uint32_t current = top[vertex];
+    if (current != NO_CONTACT && !better(key, entries[current].key))
+    {
+        return false;
+    }
+    if (current != NO_CONTACT && entries[current].time == time)
+    {
+        current = entries[current].prev;
+    }
+    top[vertex] = entries.size();
+    entries.push_back({key, time, current, contact});
+    return true;
+}
+
+// Viaggio piu' veloce (arrivo - partenza minimo) da source verso ogni vertice, in una sola
+// scansione in avanti del flusso (Wu et al.). Ogni vertice tiene la pila delle coppie
+// (partenza, arrivo) non dominate: poiche' il flusso e' ordinato per tempo basta guardare
+// la cima della pila (o l'elemento sotto, in modalita' stretta), quindi ogni contatto costa O(1).
+// duration[v] vale 0 per la sorgente e INT64_MAX se v non e' raggiungibile (in int64_t,
+// perche' con timestamp int una durata arriva a 2^32 - 1); parentContact
+// riceve l'ultimo contatto del viaggio ottimo di ogni vertice.
+void fastestJourneyScan(const ContactView &view, uint32_t source, JourneyMode mode,
+                        vector<int64_t> &duration, vector<uint32_t> *parentContact);
+
+// Viaggio piu' corto (minimo numero di contatti) da source, con pile di coppie (salti, arrivo).
+void shortestJourneyScan(const ContactView &view, uint32_t source, JourneyMode mode,
+                         vector<int> &hops, vector<uint32_t> *parentContact);
+
+#endif
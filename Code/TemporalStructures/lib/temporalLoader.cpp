@@ -0,0 +1,433 @@
+#include "temporalLoader.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <numeric>
+#include <stdexcept>
+#include <string_view>
+
+using namespace std;
+
+// Risultato dell'analisi di un pezzo di blocco: contatti con id locali al pezzo
+struct ParsedPiece
+{
+    NameTable names;
+    vector<Contact> contacts;
+    string badLine;
+};
+
+static bool isSeparator(char c)
+{
+    return c == ' ' || c == '\t' || c == ',' || c == '\r';
+}
+
+static bool parseTime(const char *begin, const char *end, int &time)
+{
+    bool negative = false;
+    if (begin != end && (*begin == '-' || *begin == '+'))
+    {
+        negative = *begin == '-';
+        begin++;
+    }
+    if (begin == end)
+    {
+        return false;
+    }
+
+    int64_t value = 0;
+    for (const char *c = begin; c != end; c++)
+    {
+        if (*c < '0' || *c > '9')
+        {
+            return false;
+        }
+        value = value * 10 + (*c - '0');
+        if (value > (int64_t)numeric_limits<int>::max() + 1)
+        {
+            return false;
+        }
+    }
+    value = negative ? -value : value;
+    if (value < numeric_limits<int>::min() || value > numeric_limits<int>::max())
+    {
+        return false;
+    }
+    time = value;
+    return true;
+}
+
+// Analizza le righe complete in [begin, end); alla prima riga non valida si ferma
+static void parsePiece(const char *begin, const char *end, ParsedPiece &piece)
+{
+    string start;
+    string finish;
+    const char *line = begin;
+    while (line < end)
+    {
+        const char *lineEnd = static_cast<const char *>(memchr(line, '\n', end - line));
+        if (lineEnd == nullptr)
+        {
+            lineEnd = end;
+        }
+
+        // primo, secondo e ultimo campo della riga
+        const char *fields[3][2];
+        size_t fieldCount = 0;
+        const char *c = line;
+        while (c < lineEnd)
+        {
+            while (c < lineEnd && isSeparator(*c))
+            {
+                c++;
+            }
+            if (c == lineEnd)
+            {
+                break;
+            }
+            const char *fieldBegin = c;
+            while (c < lineEnd && !isSeparator(*c))
+            {
+                c++;
+            }
+            if (fieldCount == 0 && (*fieldBegin == '#' || *fieldBegin == '%'))
+            {
+                break;
+            }
+            size_t slot = fieldCount < 2 ? fieldCount : 2;
+            fields[slot][0] = fieldBegin;
+            fields[slot][1] = c;
+            fieldCount++;
+        }
+
+        if (fieldCount != 0)
+        {
+            int time;
+            if (fieldCount < 3 || !parseTime(fields[2][0], fields[2][1], time))
+            {
+                piece.badLine.assign(line, lineEnd);
+                return;
+            }
+            start.assign(fields[0][0], fields[0][1]);
+            finish.assign(fields[1][0], fields[1][1]);
+            piece.contacts.push_back({piece.names.intern(start), piece.names.intern(finish), time});
+        }
+        line = lineEnd + 1;
+    }
+}
+
+// Divide il blocco in pezzi che terminano a fine riga, li analizza in parallelo e
+// accoda i contatti, con gli id globali, in contacts
+static void parseChunk(const char *begin, const char *end, ThreadPool &pool, NameTable &names,
+                       vector<Contact> &contacts)
+{
+    size_t pieceCount = pool.size() * 4;
+    vector<const char *> bounds = {begin};
+    for (size_t k = 1; k < pieceCount; k++)
+    {
+        const char *target = begin + (end - begin) * k / pieceCount;
+        target = max(target, bounds.back());
+        const char *newline = static_cast<const char *>(memchr(target, '\n', end - target));
+        bounds.push_back(newline == nullptr ? end : newline + 1);
+    }
+    bounds.push_back(end);
+
+    vector<ParsedPiece> pieces(pieceCount);
+    pool.parallelFor(pieceCount, [&](size_t k, unsigned)
+                     { parsePiece(bounds[k], bounds[k + 1], pieces[k]); });
+
+    // unione in ordine delle tabelle locali: un solo intern per nome distinto del pezzo
+    vector<vector<uint32_t>> globalIds(pieceCount);
+    vector<size_t> firstContact(pieceCount + 1, contacts.size());
+    for (size_t k = 0; k < pieceCount; k++)
+    {
+        ParsedPiece &piece = pieces[k];
+        if (!piece.badLine.empty())
+        {
+            throw runtime_error("riga non valida nella lista di contatti: " + piece.badLine);
+        }
+        globalIds[k].resize(piece.names.size());
+        for (uint32_t local = 0; local < piece.names.size(); local++)
+        {
+            globalIds[k][local] = names.intern(piece.names.name(local));
+        }
+
+        firstContact[k + 1] = firstContact[k] + piece.contacts.size();
+    }
+
+    contacts.resize(firstContact[pieceCount]);
+    pool.parallelFor(pieceCount, [&](size_t k, unsigned)
+                     {
+                         const vector<uint32_t> &ids = globalIds[k];
+                         Contact *out = contacts.data() + firstContact[k];
+                         for (const Contact &contact : pieces[k].contacts)
+                         {
+                             *out++ = {ids[contact.from], ids[contact.to], contact.time};
+                         } });
+}
+
+TemporalStorage loadEdgeList(const string &path, ThreadPool &pool, bool undirected, size_t chunkBytes)
+{
+    ifstream file(path, ios::binary);
+    if (!file)
+    {
+        throw runtime_error("impossibile aprire " + path);
+    }
+
+    TemporalStorage storage(!undirected);
+    vector<Contact> contacts;
+    vector<char> buffer(max<size_t>(chunkBytes, 1));
+    size_t filled = 0;
+
+    while (true)
+    {
+        file.read(buffer.data() + filled, buffer.size() - filled);
+        filled += file.gcount();
+        bool finished = !file;
+
+        // analizzo solo fino all'ultima riga completa; il resto passa al blocco successivo
+        size_t usable = filled;
+        if (!finished)
+        {
+            while (usable > 0 && buffer[usable - 1] != '\n')
+            {
+                usable--;
+            }
+            if (usable == 0)
+            {
+                // riga piu' lunga del blocco
+                buffer.resize(buffer.size() * 2);
+                continue;
+            }
+        }
+
+        parseChunk(buffer.data(), buffer.data() + usable, pool, storage.names, contacts);
+        if (finished)
+        {
+            break;
+        }
+        memmove(buffer.data(), buffer.data() + usable, filled - usable);
+        filled -= usable;
+    }
+
+    storage.build(move(contacts));
+    return storage;
+}
+
+static uint64_t alignSection(uint64_t position)
+{
+    return (position + 7) & ~uint64_t(7);
+}
+
+SnapshotLayout snapshotLayout(const SnapshotHeader &header)
+{
+    SnapshotLayout layout;
+    uint64_t n = header.vertexCount;
+    layout.nameOffsets = alignSection(sizeof(SnapshotHeader));
+    layout.nameChars = alignSection(layout.nameOffsets + (n + 1) * sizeof(uint64_t));
+    layout.nameIndex = alignSection(layout.nameChars + header.nameBytes);
+    layout.alive = alignSection(layout.nameIndex + n * sizeof(uint32_t));
+    layout.offsets = alignSection(layout.alive + n);
+    layout.neighbours = alignSection(layout.offsets + (n + 1) * sizeof(uint32_t));
+    layout.timeOffsets = alignSection(layout.neighbours + header.arcCount * sizeof(uint32_t));
+    layout.timestamps = alignSection(layout.timeOffsets + (header.arcCount + 1) * sizeof(uint32_t));
+    layout.contacts = alignSection(layout.timestamps + header.timestampCount * sizeof(int));
+    layout.size = layout.contacts + header.contactCount * sizeof(Contact);
+    return layout;
+}
+
+bool validSnapshot(const SnapshotHeader &header, uint64_t fileSize)
+{
+    // ogni sezione occupa almeno un byte per elemento: con i conteggi limitati dal file
+    // i prodotti e le somme di snapshotLayout restano ben sotto 2^64
+    if (header.vertexCount > fileSize || header.arcCount > fileSize || header.timestampCount > fileSize ||
+        header.contactCount > fileSize || header.nameBytes > fileSize || fileSize > (uint64_t(1) << 56))
+    {
+        return false;
+    }
+    return memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) == 0 &&
+           header.version == SNAPSHOT_VERSION && (header.flags & ~SNAPSHOT_UNDIRECTED) == 0 &&
+           header.vertexCount < NO_VERTEX &&
+           header.arcCount < NO_ARC && header.contactCount < NO_CONTACT &&
+           snapshotLayout(header).size == fileSize;
+}
+
+// offsets[0 .. count] parte da 0, non decresce e finisce in last
+template <typename T>
+static bool validOffsets(const T *offsets, uint64_t count, uint64_t last)
+{
+    if (offsets[0] != 0 || offsets[count] != last)
+    {
+        return false;
+    }
+    for (uint64_t i = 0; i < count; i++)
+    {
+        if (offsets[i] > offsets[i + 1])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool validSnapshotSections(const SnapshotHeader &header, const SnapshotSections &sections)
+{
+    uint64_t n = header.vertexCount;
+    if (!validOffsets(sections.nameOffsets, n, header.nameBytes) ||
+        !validOffsets(sections.offsets, n, header.arcCount) ||
+        !validOffsets(sections.timeOffsets, header.arcCount, header.timestampCount))
+    {
+        return false;
+    }
+
+    auto name = [&sections](uint32_t id)
+    {
+        return string_view(sections.nameChars + sections.nameOffsets[id],
+                           sections.nameOffsets[id + 1] - sections.nameOffsets[id]);
+    };
+    for (uint64_t i = 0; i < n; i++)
+    {
+        if (sections.nameIndex[i] >= n || (i > 0 && !(name(sections.nameIndex[i - 1]) < name(sections.nameIndex[i]))))
+        {
+            return false;
+        }
+    }
+    for (uint64_t a = 0; a < header.arcCount; a++)
+    {
+        if (sections.neighbours[a] >= n)
+        {
+            return false;
+        }
+    }
+    for (uint64_t i = 0; i < header.contactCount; i++)
+    {
+        const Contact &contact = sections.contacts[i];
+        if (contact.from >= n || contact.to >= n || (i > 0 && sections.contacts[i - 1].time > contact.time))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void writeSection(ofstream &file, uint64_t position, const void *data, size_t bytes)
+{
+    static const char padding[8] = {};
+    uint64_t current = file.tellp();
+    file.write(padding, position - current);
+    file.write(static_cast<const char *>(data), bytes);
+}
+
+void writeSnapshot(const TemporalStorage &storage, const string &path)
+{
+    uint32_t n = storage.vertexCount();
+    vector<uint64_t> nameOffsets(n + 1, 0);
+    string nameChars;
+    vector<uint8_t> alive(n);
+    for (uint32_t u = 0; u < n; u++)
+    {
+        nameChars += storage.names.name(u);
+        nameOffsets[u + 1] = nameChars.size();
+        alive[u] = storage.isAlive(u);
+    }
+
+    vector<uint32_t> nameIndex(n);
+    iota(nameIndex.begin(), nameIndex.end(), 0);
+    sort(nameIndex.begin(), nameIndex.end(), [&storage](uint32_t a, uint32_t b)
+         { return storage.names.name(a) < storage.names.name(b); });
+
+    SnapshotHeader header = {};
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = SNAPSHOT_VERSION;
+    header.flags = storage.directed ? 0 : SNAPSHOT_UNDIRECTED;
+    header.vertexCount = n;
+    header.arcCount = storage.arcCount();
+    header.timestampCount = storage.timestamps.size();
+    header.contactCount = storage.contacts.size();
+    header.nameBytes = nameChars.size();
+    SnapshotLayout layout = snapshotLayout(header);
+
+    ofstream file(path, ios::binary | ios::trunc);
+    if (!file)
+    {
+        throw runtime_error("impossibile scrivere " + path);
+    }
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    writeSection(file, layout.nameOffsets, nameOffsets.data(), nameOffsets.size() * sizeof(uint64_t));
+    writeSection(file, layout.nameChars, nameChars.data(), nameChars.size());
+    writeSection(file, layout.nameIndex, nameIndex.data(), nameIndex.size() * sizeof(uint32_t));
+    writeSection(file, layout.alive, alive.data(), alive.size());
+    writeSection(file, layout.offsets, storage.offsets.data(), storage.offsets.size() * sizeof(uint32_t));
+    writeSection(file, layout.neighbours, storage.neighbours.data(), storage.neighbours.size() * sizeof(uint32_t));
+    writeSection(file, layout.timeOffsets, storage.timeOffsets.data(), storage.timeOffsets.size() * sizeof(uint32_t));
+    writeSection(file, layout.timestamps, storage.timestamps.data(), storage.timestamps.size() * sizeof(int));
+    writeSection(file, layout.contacts, storage.contacts.data(), storage.contacts.size() * sizeof(Contact));
+    if (!file)
+    {
+        throw runtime_error("errore di scrittura su " + path);
+    }
+}
+
+template <typename T>
+static void readSection(ifstream &file, uint64_t position, vector<T> &data, uint64_t count)
+{
+    data.resize(count);
+    file.seekg(position);
+    file.read(reinterpret_cast<char *>(data.data()), count * sizeof(T));
+}
+
+TemporalStorage readSnapshot(const string &path)
+{
+    ifstream file(path, ios::binary | ios::ate);
+    if (!file)
+    {
+        throw runtime_error("impossibile aprire " + path);
+    }
+    uint64_t fileSize = file.tellg();
+    file.seekg(0);
+
+    SnapshotHeader header;
+    file.read(reinterpret_cast<char *>(&header), sizeof(header));
+    if (!file || !validSnapshot(header, fileSize))
+    {
+        throw runtime_error(path + " non e' uno snapshot valido");
+    }
+    SnapshotLayout layout = snapshotLayout(header);
+    uint64_t n = header.vertexCount;
+
+    TemporalStorage storage((header.flags & SNAPSHOT_UNDIRECTED) == 0);
+    vector<uint64_t> nameOffsets;
+    vector<char> nameChars;
+    vector<uint32_t> nameIndex;
+    vector<uint8_t> alive;
+    readSection(file, layout.nameOffsets, nameOffsets, n + 1);
+    readSection(file, layout.nameChars, nameChars, header.nameBytes);
+    readSection(file, layout.nameIndex, nameIndex, n);
+    readSection(file, layout.alive, alive, n);
+    readSection(file, layout.offsets, storage.offsets, n + 1);
+    readSection(file, layout.neighbours, storage.neighbours, header.arcCount);
+    readSection(file, layout.timeOffsets, storage.timeOffsets, header.arcCount + 1);
+    readSection(file, layout.timestamps, storage.timestamps, header.timestampCount);
+    readSection(file, layout.contacts, storage.contacts, header.contactCount);
+    if (!file)
+    {
+        throw runtime_error("errore di lettura da " + path);
+    }
+    SnapshotSections sections = {nameOffsets.data(), nameChars.data(), nameIndex.data(), storage.offsets.data(),
+                                 storage.neighbours.data(), storage.timeOffsets.data(), storage.contacts.data()};
+    if (!validSnapshotSections(header, sections))
+    {
+        throw runtime_error(path + " non e' uno snapshot valido");
+    }
+
+    storage.names.names.reserve(n);
+    storage.names.ids.reserve(n);
+    for (uint64_t u = 0; u < n; u++)
+    {
+        storage.names.intern(string(nameChars.data() + nameOffsets[u], nameChars.data() + nameOffsets[u + 1]));
+    }
+    storage.alive.assign(alive.begin(), alive.end());
+    storage.rehashContacts();
+    storage.indexReverseArcs();
+    return storage;
+}
@@ -0,0 +1,95 @@
+#ifndef TEMPORALLOADER_H
+#define TEMPORALLOADER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "temporalStorage.h"
+#include "threadPool.h"
+
+using namespace std;
+
+// dimensione predefinita dei blocchi letti dal file di testo
+const size_t LOADER_CHUNK_BYTES = size_t(64) << 20;
+
+// Legge una lista di contatti testuale in stile SNAP/KONECT: una riga "u v ... t" per
+// contatto, campi separati da spazi, tabulazioni o virgole, tempo intero nell'ultimo
+// campo; le righe vuote e quelle che iniziano con '#' o '%' vengono ignorate.
+// Il file viene letto a blocchi di chunkBytes e ogni blocco viene diviso tra i worker
+// del pool, che analizzano le righe e internano i nomi in tabelle locali; le tabelle
+// vengono poi unite in ordine, quindi gli id seguono l'ordine di prima comparsa nel file.
+// Con undirected lo storage e' non orientato: ogni contatto e' memorizzato una volta
+// e le scansioni lo percorrono in entrambe le direzioni. Lancia runtime_error se il file
+// non si apre o una riga non e' valida.
+TemporalStorage loadEdgeList(const string &path, ThreadPool &pool, bool undirected = true,
+                             size_t chunkBytes = LOADER_CHUNK_BYTES);
+
+// Snapshot binario del TemporalStorage. Dopo l'intestazione le sezioni sono scritte
+// una dopo l'altra, ognuna allineata a 8 byte, nell'ordine di SnapshotLayout: il file
+// ha quindi la stessa forma degli array in memoria e puo' essere mappato direttamente.
+// I valori sono nell'ordine dei byte della macchina che ha scritto lo snapshot.
+const char SNAPSHOT_MAGIC[8] = {'T', 'G', 'S', 'N', 'A', 'P', '\0', '\0'};
+const uint32_t SNAPSHOT_VERSION = 1;
+
+// bit di SnapshotHeader::flags
+const uint32_t SNAPSHOT_UNDIRECTED = 1;
+
+struct SnapshotHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t flags; // SNAPSHOT_UNDIRECTED; gli altri bit sono riservati e valgono 0
+    uint64_t vertexCount;
+    uint64_t arcCount;
+    uint64_t timestampCount;
+    uint64_t contactCount;
+    uint64_t nameBytes;
+};
+
+// posizione in byte, dall'inizio del file, di ogni sezione dello snapshot
+struct SnapshotLayout
+{
+    uint64_t nameOffsets;   // uint64_t[vertexCount + 1], inizio di ogni nome in nameChars
+    uint64_t nameChars;     // char[nameBytes], nomi concatenati senza terminatore
+    uint64_t nameIndex;     // uint32_t[vertexCount], id ordinati per nome (ricerca binaria)
+    uint64_t alive;         // uint8_t[vertexCount]
+    uint64_t offsets;       // uint32_t[vertexCount + 1]
+    uint64_t neighbours;    // uint32_t[arcCount]
+    uint64_t timeOffsets;   // uint32_t[arcCount + 1]
+    uint64_t timestamps;    // int[timestampCount]
+    uint64_t contacts;      // Contact[contactCount]
+    uint64_t size;          // dimensione totale del file
+};
+
+SnapshotLayout snapshotLayout(const SnapshotHeader &header);
+
+// controlla magic, versione e che la dimensione del file corrisponda alle sezioni; ogni
+// conteggio dell'intestazione viene limitato da fileSize prima di calcolare il layout,
+// cosi' le somme delle sezioni non possono traboccare
+bool validSnapshot(const SnapshotHeader &header, uint64_t fileSize);
+
+// sezioni di uno snapshot gia' in memoria, lette o mappate dal file
+struct SnapshotSections
+{
+    const uint64_t *nameOffsets;
+    const char *nameChars;
+    const uint32_t *nameIndex;
+    const uint32_t *offsets;
+    const uint32_t *neighbours;
+    const uint32_t *timeOffsets;
+    const Contact *contacts;
+};
+
+// controlla che gli array di offset siano monotoni e terminino alla dimensione della
+// sezione che indicizzano, che nameIndex sia ordinato per nome senza duplicati e che ogni
+// id (vicini, estremi dei contatti) sia minore di vertexCount e che i contatti siano
+// ordinati per tempo (timeWindow e le scansioni lo assumono): le query sullo snapshot
+// non escono dal file. O(dimensione del file).
+bool validSnapshotSections(const SnapshotHeader &header, const SnapshotSections &sections);
+
+// Lancia runtime_error se il file non si apre o non e' uno snapshot valido
+void writeSnapshot(const TemporalStorage &storage, const string &path);
+TemporalStorage readSnapshot(const string &path);
+
+#endif
@@ -0,0 +1,98 @@
+#include "temporalMatrix.h"
+
+#include <numeric>
+
+using namespace std;
+
+// Esegue i blocchi di sorgenti sul pool e passa lo stato di ogni blocco a write(primaSorgente, quante, stato)
+template <bool Earliest, typename Write>
+static void runBlocks(const ContactView &view, ThreadPool &pool, JourneyMode mode, Write write)
+{
+    vector<uint32_t> ids(view.vertexCount);
+    iota(ids.begin(), ids.end(), 0);
+
+    vector<vector<SourceLanes<MATRIX_BLOCK>>> states(pool.size());
+    vector<GroupScratch> scratches(pool.size());
+    size_t blocks = (view.vertexCount + MATRIX_BLOCK - 1) / MATRIX_BLOCK;
+
+    pool.parallelFor(blocks, [&](size_t block, unsigned worker)
+                     {
+                         size_t first = block * MATRIX_BLOCK;
+                         size_t count = min(MATRIX_BLOCK, view.vertexCount - first);
+                         if (Earliest)
+                         {
+                             earliestArrivalBlock<MATRIX_BLOCK>(view, ids.data() + first, count, mode,
+                                                                states[worker], scratches[worker]);
+                         }
+                         else
+                         {
+                             latestDepartureBlock<MATRIX_BLOCK>(view, ids.data() + first, count, mode,
+                                                                states[worker], scratches[worker]);
+                         }
+                         write(first, count, states[worker]); });
+}
+
+template <bool Earliest>
+static void timeMatrix(const ContactView &view, ThreadPool &pool, JourneyMode mode, vector<int> &matrix)
+{
+    size_t n = view.vertexCount;
+    if (matrix.size() != n * n)
+    {
+        matrix.resize(n * n);
+    }
+
+    runBlocks<Earliest>(view, pool, mode,
+                        [&](size_t first, size_t count, const vector<SourceLanes<MATRIX_BLOCK>> &state)
+                        {
+                            for (size_t k = 0; k < count; k++)
+                            {
+                                int *row = matrix.data() + (first + k) * n;
+                                for (size_t v = 0; v < n; v++)
+                                {
+                                    row[v] = state[v].lane[k];
+                                }
+                            }
+                        });
+}
+
+void earliestArrivalMatrix(const ContactView &view, ThreadPool &pool, JourneyMode mode, vector<int> &matrix)
+{
+    timeMatrix<true>(view, pool, mode, matrix);
+}
+
+void latestDepartureMatrix(const ContactView &view, ThreadPool &pool, JourneyMode mode, vector<int> &matrix)
+{
+    timeMatrix<false>(view, pool, mode, matrix);
+}
+
+size_t reachabilityWords(uint32_t vertexCount)
+{
+    return (vertexCount + 63) / 64;
+}
+
+void reachabilityMatrix(const ContactView &view, ThreadPool &pool, JourneyMode mode, vector<uint64_t> &bits)
+{
+    size_t n = view.vertexCount;
+    size_t words = reachabilityWords(view.vertexCount);
+    if (bits.size() != n * words)
+    {
+        bits.resize(n * words);
+    }
+
+    runBlocks<true>(view, pool, mode,
+                    [&](size_t first, size_t count, const vector<SourceLanes<MATRIX_BLOCK>> &state)
+                    {
+                        for (size_t k = 0; k < count; k++)
+                        {
+                            uint64_t *row = bits.data() + (first + k) * words;
+                            fill(row, row + words, 0);
+                            for (size_t v = 0; v < n; v++)
+                            {
+                                if (state[v].lane[k] != numeric_limits<int>::max())
+                                {
+                                    row[v / 64] |= uint64_t(1) << (v % 64);
+                                }
+                            }
+                        }
+                    });
+}
@@ -0,0 +1,28 @@
+#ifndef TEMPORALMATRIX_H
+#define TEMPORALMATRIX_H
+
+#include <cstdint>
+#include <vector>
+
+#include "multiSourceScan.h"
+#include "threadPool.h"
+
+using namespace std;
+
+// numero di sorgenti elaborate da ogni task del pool
+const size_t MATRIX_BLOCK = 32;
+
+// Matrici vertexCount x vertexCount per righe, indicizzate per id: la riga s contiene
+// earliest arrival da s (latest departure verso s). I blocchi di MATRIX_BLOCK sorgenti
+// vengono distribuiti sul pool; grafo e flusso sono condivisi in sola lettura e ogni
+// worker riusa i propri buffer, quindi l'unica allocazione e' quella della matrice,
+// fatta solo se non ha gia' la dimensione giusta.
+void earliestArrivalMatrix(const ContactView &view, ThreadPool &pool, JourneyMode mode, vector<int> &matrix);
+void latestDepartureMatrix(const ContactView &view, ThreadPool &pool, JourneyMode mode, vector<int> &matrix);
+
+// Raggiungibilita' temporale come bitset: la riga s occupa reachabilityWords(vertexCount)
+// parole e il bit v e' acceso se v e' raggiungibile da s.
+size_t reachabilityWords(uint32_t vertexCount);
+void reachabilityMatrix(const ContactView &view, ThreadPool &pool, JourneyMode mode, vector<uint64_t> &bits);
+
+#endif
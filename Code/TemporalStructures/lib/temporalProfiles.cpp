@@ -0,0 +1,121 @@
+#include "temporalProfiles.h"
+
+using namespace std;
+
+static void resetProfile(TemporalProfile &profile, uint32_t vertexCount)
+{
+    profile.log.clear();
+    profile.top.assign(vertexCount, NO_CONTACT);
+    profile.offsets.assign(vertexCount + 1, 0);
+    profile.entries.clear();
+}
+
+// Trasforma le pile del registro in CSR. Le pile del profilo di earliest arrival crescono
+// per partenza crescente, quelle di latest departure per partenza decrescente.
+static void flattenProfile(TemporalProfile &profile, bool forward)
+{
+    uint32_t n = profile.top.size();
+    for (uint32_t v = 0; v < n; v++)
+    {
+        uint32_t size = 0;
+        for (uint32_t entry = profile.top[v]; entry != NO_CONTACT; entry = profile.log[entry].prev)
+        {
+            size++;
+        }
+        profile.offsets[v + 1] = profile.offsets[v] + size;
+    }
+
+    profile.entries.resize(profile.offsets[n]);
+    for (uint32_t v = 0; v < n; v++)
+    {
+        uint32_t position = forward ? profile.offsets[v + 1] : profile.offsets[v];
+        for (uint32_t entry = profile.top[v]; entry != NO_CONTACT; entry = profile.log[entry].prev)
+        {
+            const ParetoEntry &pareto = profile.log[entry];
+            ProfileEntry flat = forward ? ProfileEntry{pareto.key, pareto.time, pareto.contact}
+                                        : ProfileEntry{pareto.time, pareto.key, pareto.contact};
+            if (forward)
+            {
+                profile.entries[--position] = flat;
+            }
+            else
+            {
+                profile.entries[position++] = flat;
+            }
+        }
+    }
+}
+
+void earliestArrivalProfile(const ContactView &view, uint32_t source, JourneyMode mode, TemporalProfile &profile)
+{
+    resetProfile(profile, view.vertexCount);
+    if (source == NO_VERTEX)
+    {
+        return;
+    }
+
+    bool strict = mode == JourneyMode::Strict;
+    auto relax = [&](size_t i, uint32_t tail, uint32_t head)
+    {
+        int time = view.contacts[i].time;
+        if (head == source)
+        {
+            return false;
+        }
+
+        int departure = time;
+        if (tail != source)
+        {
+            uint32_t entry = paretoUsable(profile.log, profile.top, tail, time, strict);
+            if (entry == NO_CONTACT)
+            {
+                return false;
+            }
+            departure = profile.log[entry].key;
+        }
+        // a parita' di arrivo conviene partire piu' tardi
+        return paretoPush(profile.log, profile.top, head, departure, time, i, [](int key, int other)
+                          { return key > other; });
+    };
+
+    GroupScratch scratch;
+    scanTimeGroups(view, true, mode, scratch, relax);
+    flattenProfile(profile, true);
+}
+
+void latestDepartureProfile(const ContactView &view, uint32_t destination, JourneyMode mode, TemporalProfile &profile)
+{
+    resetProfile(profile, view.vertexCount);
+    if (destination == NO_VERTEX)
+    {
+        return;
+    }
+
+    bool strict = mode == JourneyMode::Strict;
+    auto relax = [&](size_t i, uint32_t tail, uint32_t head)
+    {
+        int time = view.contacts[i].time;
+        if (head == destination)
+        {
+            return false;
+        }
+
+        int arrival = time;
+        if (tail != destination)
+        {
+            uint32_t entry = paretoUsable(profile.log, profile.top, tail, time, strict);
+            if (entry == NO_CONTACT)
+            {
+                return false;
+            }
+            arrival = profile.log[entry].key;
+        }
+        // a parita' di partenza conviene arrivare prima
+        return paretoPush(profile.log, profile.top, head, arrival, time, i, [](int key, int other)
+                          { return key < other; });
+    };
+
+    GroupScratch scratch;
+    scanTimeGroups(view, false, mode, scratch, relax);
+    flattenProfile(profile, false);
+}
@@ -0,0 +1,43 @@
+#ifndef TEMPORALPROFILES_H
+#define TEMPORALPROFILES_H
+
+#include <cstdint>
+#include <vector>
+
+#include "temporalJourneys.h"
+
+using namespace std;
+
+// Coppia non dominata di un profilo: partendo all'istante departure si arriva ad arrival.
+// contact e' l'ultimo contatto del viaggio per il profilo di earliest arrival e il primo
+// per quello di latest departure.
+struct ProfileEntry
+{
+    int departure;
+    int arrival;
+    uint32_t contact;
+};
+
+// Profili di tutti i vertici in formato CSR: le coppie del vertice v sono
+// entries[offsets[v] .. offsets[v + 1]), ordinate per partenza (e quindi arrivo) crescente.
+// I buffer vengono riusati tra una query e l'altra.
+struct TemporalProfile
+{
+    vector<uint32_t> offsets;
+    vector<ProfileEntry> entries;
+
+    // registro delle pile usato durante la scansione
+    vector<ParetoEntry> log;
+    vector<uint32_t> top;
+};
+
+// Profilo di earliest arrival da source: per ogni destinazione v, l'insieme di Pareto delle
+// coppie (partenza da source, arrivo in v), in un'unica scansione in avanti.
+// Il profilo della sorgente stessa e' vuoto.
+void earliestArrivalProfile(const ContactView &view, uint32_t source, JourneyMode mode, TemporalProfile &profile);
+
+// Profilo di latest departure verso destination: per ogni origine v, l'insieme di Pareto delle
+// coppie (partenza da v, arrivo in destination), in un'unica scansione all'indietro.
+void latestDepartureProfile(const ContactView &view, uint32_t destination, JourneyMode mode, TemporalProfile &profile);
+
+#endif
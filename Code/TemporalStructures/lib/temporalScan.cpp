@@ -0,0 +1,131 @@
+#include "temporalScan.h"
+
+using namespace std;
+
+ContactView makeContactView(const TemporalStorage &storage)
+{
+    return {storage.contacts.data(), 0, storage.contacts.size(), storage.vertexCount(), !storage.directed};
+}
+
+ContactView timeWindow(const ContactView &view, int timeStart, int timeEnd)
+{
+    const Contact *begin = view.contacts + view.first;
+    const Contact *end = view.contacts + view.last;
+    const Contact *windowBegin = lower_bound(begin, end, timeStart,
+                                             [](const Contact &contact, int time)
+                                             {
+                                                 return contact.time < time;
+                                             });
+    const Contact *windowEnd = upper_bound(windowBegin, end, timeEnd,
+                                           [](int time, const Contact &contact)
+                                           {
+                                               return time < contact.time;
+                                           });
+
+    ContactView window = view;
+    window.first = windowBegin - view.contacts;
+    window.last = max(windowBegin, windowEnd) - view.contacts;
+    return window;
+}
+
+template <typename Times, typename Parents>
+static void earliestArrivalInto(const ContactView &view, uint32_t source, JourneyMode mode,
+                                Times &ea, Parents *parentContact, GroupScratch &scratch)
+{
+    TEMPORAL_PHASE("earliestArrivalScan");
+    TEMPORAL_COUNT(queries, 1);
+    ea.assign(view.vertexCount, numeric_limits<int>::max());
+    if (parentContact != nullptr)
+    {
+        parentContact->assign(view.vertexCount, NO_CONTACT);
+    }
+    if (source == NO_VERTEX)
+    {
+        return;
+    }
+    ea[source] = numeric_limits<int>::min();
+
+    bool strict = mode == JourneyMode::Strict;
+    auto relax = [&](size_t i, uint32_t tail, uint32_t head)
+    {
+        int time = view.contacts[i].time;
+        bool usable = strict ? ea[tail] < time : ea[tail] <= time;
+        if (usable && time < ea[head])
+        {
+            ea[head] = time;
+            if (parentContact != nullptr)
+            {
+                (*parentContact)[head] = i;
+            }
+            TEMPORAL_COUNT(relaxations, 1);
+            return true;
+        }
+        return false;
+    };
+
+    scanTimeGroups(view, true, mode, scratch, relax);
+}
+
+template <typename Times, typename Parents>
+static void latestDepartureInto(const ContactView &view, uint32_t destination, JourneyMode mode,
+                                Times &ld, Parents *parentContact, GroupScratch &scratch)
+{
+    TEMPORAL_PHASE("latestDepartureScan");
+    TEMPORAL_COUNT(queries, 1);
+    ld.assign(view.vertexCount, numeric_limits<int>::min());
+    if (parentContact != nullptr)
+    {
+        parentContact->assign(view.vertexCount, NO_CONTACT);
+    }
+    if (destination == NO_VERTEX)
+    {
+        return;
+    }
+    ld[destination] = numeric_limits<int>::max();
+
+    bool strict = mode == JourneyMode::Strict;
+    auto relax = [&](size_t i, uint32_t tail, uint32_t head)
+    {
+        int time = view.contacts[i].time;
+        bool usable = strict ? time < ld[tail] : time <= ld[tail];
+        if (usable && time > ld[head])
+        {
+            ld[head] = time;
+            if (parentContact != nullptr)
+            {
+                (*parentContact)[head] = i;
+            }
+            TEMPORAL_COUNT(relaxations, 1);
+            return true;
+        }
+        return false;
+    };
+
+    scanTimeGroups(view, false, mode, scratch, relax);
+}
+
+void earliestArrivalScan(const ContactView &view, uint32_t source, JourneyMode mode,
+                         vector<int> &ea, vector<uint32_t> *parentContact)
+{
+    GroupScratch scratch;
+    earliestArrivalInto(view, source, mode, ea, parentContact, scratch);
+}
+
+void earliestArrivalScan(const ContactView &view, uint32_t source, JourneyMode mode, pmr::vector<int> &ea,
+                         pmr::vector<uint32_t> *parentContact, GroupScratch &scratch)
+{
+    earliestArrivalInto(view, source, mode, ea, parentContact, scratch);
+}
+
+void latestDepartureScan(const ContactView &view, uint32_t destination, JourneyMode mode,
+                         vector<int> &ld, vector<uint32_t> *parentContact)
+{
+    GroupScratch scratch;
+    latestDepartureInto(view, destination, mode, ld, parentContact, scratch);
+}
+
+void latestDepartureScan(const ContactView &view, uint32_t destination, JourneyMode mode, pmr::vector<int> &ld,
+                         pmr::vector<uint32_t> *parentContact, GroupScratch &scratch)
+{
+    latestDepartureInto(view, destination, mode, ld, parentContact, scratch);
+}
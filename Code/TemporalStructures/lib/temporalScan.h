@@ -0,0 +1,202 @@
+#ifndef TEMPORALSCAN_H
+#define TEMPORALSCAN_H
+
+#include <algorithm>
+#include <cstdint>
+#include <memory_resource>
+#include <utility>
+#include <vector>
+
+#include "queryStats.h"
+#include "temporalStorage.h"
+
+using namespace std;
+
+enum class JourneyMode
+{
+    NonStrict, // contatti consecutivi di un viaggio possono avere lo stesso timestamp
+    Strict     // ogni contatto deve avere timestamp strettamente maggiore del precedente
+};
+
+// Vista in sola lettura sull'intervallo [first, last) del flusso ordinato di contatti.
+// Gli indici dei contatti restano quelli assoluti del flusso. Se undirected, ogni
+// contatto vale in entrambe le direzioni e le scansioni lo percorrono due volte.
+struct ContactView
+{
+    const Contact *contacts;
+    size_t first;
+    size_t last;
+    uint32_t vertexCount;
+    bool undirected;
+};
+
+ContactView makeContactView(const TemporalStorage &storage);
+
+// Restringe la vista ai contatti con tempo in [timeStart, timeEnd] con due ricerche
+// binarie sul flusso ordinato: le scansioni sulla vista risultante toccano solo quei contatti.
+ContactView timeWindow(const ContactView &view, int timeStart, int timeEnd);
+
+// Estremo raggiunto percorrendo il contatto a partire da tail nella direzione della scansione
+inline uint32_t contactHead(const ContactView &view, const Contact &contact, uint32_t tail, bool forward)
+{
+    if (view.undirected)
+    {
+        return contact.from == tail ? contact.to : contact.from;
+    }
+    return forward ? contact.to : contact.from;
+}
+
+// sotto questa dimensione un gruppo viene ripropagato senza indice locale
+const size_t SMALL_TIME_GROUP = 16;
+
+// Buffer di appoggio della scansione a gruppi, riusabili tra un gruppo e l'altro
+struct GroupScratch
+{
+    pmr::vector<pair<uint32_t, uint32_t>> local;
+    pmr::vector<pair<uint32_t, uint32_t>> queue;
+
+    explicit GroupScratch(pmr::memory_resource *resource = pmr::get_default_resource())
+        : local(resource), queue(resource)
+    {
+    }
+};
+
+// Ripropaga i miglioramenti avvenuti nel gruppo di contatti [first, last), che hanno tutti
+// lo stesso timestamp. scratch.queue contiene le coppie (vertice migliorato, contatto in cui
+// e' migliorato): vanno ririlassati solo i contatti del gruppo che partono da quel vertice e
+// che la scansione aveva gia' visitato fino a quel contatto compreso (NO_CONTACT = tutti);
+// il contatto stesso e' incluso perche' nei grafi non orientati la sua seconda direzione
+// puo' essere stata visitata prima del miglioramento.
+// Un valore migliora al piu' una volta per gruppo, quindi il costo resta lineare nella
+// dimensione del gruppo (a meno dell'ordinamento locale dei gruppi grandi).
+template <typename Relax>
+void propagateTimeGroup(const ContactView &view, size_t first, size_t last, bool forward,
+                        GroupScratch &scratch, Relax relax)
+{
+    auto visitedBefore = [forward](uint32_t contact, uint32_t limit)
+    {
+        return limit == NO_CONTACT || (forward ? contact <= limit : contact >= limit);
+    };
+    auto leaves = [&view, forward](const Contact &contact, uint32_t tail)
+    {
+        return (forward ? contact.from : contact.to) == tail ||
+               (view.undirected && (forward ? contact.to : contact.from) == tail);
+    };
+
+    // nei gruppi piccoli una scansione lineare costa meno dell'ordinamento locale
+    if (last - first <= SMALL_TIME_GROUP)
+    {
+        for (size_t q = 0; q < scratch.queue.size(); q++)
+        {
+            auto [tail, limit] = scratch.queue[q];
+            for (size_t i = first; i < last; i++)
+            {
+                const Contact &contact = view.contacts[i];
+                if (leaves(contact, tail) && visitedBefore(i, limit))
+                {
+                    uint32_t head = contactHead(view, contact, tail, forward);
+                    if (relax(i, tail, head))
+                    {
+                        scratch.queue.push_back({head, NO_CONTACT});
+                    }
+                }
+            }
+        }
+        return;
+    }
+
+    scratch.local.clear();
+    for (size_t i = first; i < last; i++)
+    {
+        const Contact &contact = view.contacts[i];
+        scratch.local.push_back({forward ? contact.from : contact.to, (uint32_t)i});
+        if (view.undirected && contact.from != contact.to)
+        {
+            scratch.local.push_back({forward ? contact.to : contact.from, (uint32_t)i});
+        }
+    }
+    sort(scratch.local.begin(), scratch.local.end());
+
+    for (size_t q = 0; q < scratch.queue.size(); q++)
+    {
+        auto [tail, limit] = scratch.queue[q];
+        auto arc = lower_bound(scratch.local.begin(), scratch.local.end(), make_pair(tail, (uint32_t)first));
+        for (; arc != scratch.local.end() && arc->first == tail; arc++)
+        {
+            uint32_t head = contactHead(view, view.contacts[arc->second], tail, forward);
+            if (visitedBefore(arc->second, limit) && relax(arc->second, tail, head))
+            {
+                scratch.queue.push_back({head, NO_CONTACT});
+            }
+        }
+    }
+}
+
+// Scansione del flusso in un unico passaggio, in avanti (forward: l'informazione va da
+// from a to, come per l'earliest arrival) o all'indietro (da to a from, come per il latest
+// departure). relax(indice, coda, testa) restituisce true se il valore della testa e'
+// migliorato; nei grafi non orientati ogni contatto viene rilassato in entrambe le
+// direzioni, senza materializzare il contatto inverso. I contatti con lo stesso timestamp
+// formano un gruppo: in modalita' non stretta, alla fine del gruppo i miglioramenti
+// vengono ripropagati con propagateTimeGroup, cosi' le catene di contatti simultanei sono
+// risolte in qualunque ordine compaiano.
+template <typename Relax>
+void scanTimeGroups(const ContactView &view, bool forward, JourneyMode mode, GroupScratch &scratch, Relax relax)
+{
+    bool propagate = mode == JourneyMode::NonStrict;
+    size_t count = view.last - view.first;
+    size_t groupStart = 0;
+    scratch.queue.clear();
+    TEMPORAL_COUNT(contactsScanned, count);
+
+    for (size_t step = 0; step < count; step++)
+    {
+        size_t i = forward ? view.first + step : view.last - 1 - step;
+        const Contact &contact = view.contacts[i];
+        uint32_t tail = forward ? contact.from : contact.to;
+        uint32_t head = forward ? contact.to : contact.from;
+        if (relax(i, tail, head) && propagate)
+        {
+            scratch.queue.push_back({head, (uint32_t)i});
+        }
+        if (view.undirected && tail != head && relax(i, head, tail) && propagate)
+        {
+            scratch.queue.push_back({tail, (uint32_t)i});
+        }
+
+        size_t next = forward ? i + 1 : i - 1;
+        if (step + 1 == count || view.contacts[next].time != contact.time)
+        {
+            if (!scratch.queue.empty())
+            {
+                if (step > groupStart)
+                {
+                    size_t groupFirst = forward ? view.first + groupStart : i;
+                    size_t groupLast = forward ? i + 1 : view.last - groupStart;
+                    propagateTimeGroup(view, groupFirst, groupLast, forward, scratch, relax);
+                }
+                scratch.queue.clear();
+            }
+            groupStart = step + 1;
+        }
+    }
+}
+
+// Earliest arrival da source in un'unica scansione in avanti, un gruppo di timestamp alla volta.
+// ea viene ridimensionato a vertexCount; se parentContact non e' nullo vi si registra,
+// per ogni vertice, l'indice del contatto che ne ha fissato il tempo (NO_CONTACT altrimenti).
+void earliestArrivalScan(const ContactView &view, uint32_t source, JourneyMode mode,
+                         vector<int> &ea, vector<uint32_t> *parentContact);
+
+// Latest departure verso destination in un'unica scansione all'indietro.
+void latestDepartureScan(const ContactView &view, uint32_t destination, JourneyMode mode,
+                         vector<int> &ld, vector<uint32_t> *parentContact);
+
+// Varianti con vettori e buffer di appoggio presi da un memory_resource (QueryWorkspace):
+// la scansione non alloca se le capacita' bastano
+void earliestArrivalScan(const ContactView &view, uint32_t source, JourneyMode mode, pmr::vector<int> &ea,
+                         pmr::vector<uint32_t> *parentContact, GroupScratch &scratch);
+void latestDepartureScan(const ContactView &view, uint32_t destination, JourneyMode mode, pmr::vector<int> &ld,
+                         pmr::vector<uint32_t> *parentContact, GroupScratch &scratch);
+
+#endif
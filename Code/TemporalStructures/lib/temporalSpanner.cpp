@@ -0,0 +1,146 @@
+#include "temporalSpanner.h"
+
+#include <algorithm>
+
+using namespace std;
+
+// parole del bitset unite da ogni task della riduzione finale
+const size_t SPANNER_MERGE_WORDS = 4096;
+
+// Buffer di un worker, riusati da un blocco di radici all'altro
+struct SpannerWorker
+{
+    vector<SourceLanes<SPANNER_BLOCK>> state;
+    vector<uint32_t> settled;
+    GroupScratch scratch;
+};
+
+// Dai tempi finali del blocco (earliest arrival da, o latest departure verso, ogni radice)
+// ricava gli alberi con una seconda scansione: il contatto tail -> head al tempo t diventa il
+// padre di head nella corsia k se fissa il tempo di head e tail lo precede strettamente,
+// oppure ha lo stesso tempo ma ha gia' un padre. settled[v] ha un bit per corsia e impedisce
+// sia il secondo padre sia i cicli tra vertici con lo stesso tempo; le catene di contatti
+// simultanei in ordine qualsiasi sono risolte dalla ripropagazione dei gruppi.
+template <bool Earliest>
+static void markTrees(const ContactView &view, const uint32_t *roots, size_t count, JourneyMode mode,
+                      SpannerWorker &worker, vector<uint64_t> &bits)
+{
+    worker.settled.assign(view.vertexCount, 0);
+    for (size_t k = 0; k < count; k++)
+    {
+        worker.settled[roots[k]] |= uint32_t(1) << k;
+    }
+    uint32_t lanes = count == 32 ? ~uint32_t(0) : (uint32_t(1) << count) - 1;
+    bool strict = mode == JourneyMode::Strict;
+
+    auto relax = [&](size_t i, uint32_t tail, uint32_t head)
+    {
+        if (tail == head)
+        {
+            return false;
+        }
+        int time = view.contacts[i].time;
+        const SourceLanes<SPANNER_BLOCK> &tailTimes = worker.state[tail];
+        const SourceLanes<SPANNER_BLOCK> &headTimes = worker.state[head];
+        uint32_t tailSettled = strict ? 0 : worker.settled[tail];
+
+        uint32_t mask = 0;
+        for (size_t k = 0; k < SPANNER_BLOCK; k++)
+        {
+            bool fixes = headTimes.lane[k] == time;
+            bool before = Earliest ? tailTimes.lane[k] < time : tailTimes.lane[k] > time;
+            bool sameTime = tailTimes.lane[k] == time && ((tailSettled >> k) & 1);
+            mask |= uint32_t(fixes & (before | sameTime)) << k;
+        }
+        mask &= lanes & ~worker.settled[head];
+        if (mask == 0)
+        {
+            return false;
+        }
+        worker.settled[head] |= mask;
+        bits[i / 64] |= uint64_t(1) << (i % 64);
+        return true;
+    };
+
+    scanTimeGroups(view, Earliest, mode, worker.scratch, relax);
+}
+
+void buildTemporalSpanner(const ContactView &view, const vector<uint32_t> &roots, ThreadPool &pool,
+                          JourneyMode mode, TemporalSpanner &spanner)
+{
+    vector<SpannerWorker> workers(pool.size());
+    vector<vector<uint64_t>> workerBits(pool.size(), vector<uint64_t>((view.last + 63) / 64, 0));
+
+    size_t blocks = (roots.size() + SPANNER_BLOCK - 1) / SPANNER_BLOCK;
+    pool.parallelFor(blocks, [&](size_t block, unsigned w)
+                     {
+                         SpannerWorker &worker = workers[w];
+                         const uint32_t *blockRoots = roots.data() + block * SPANNER_BLOCK;
+                         size_t count = min(SPANNER_BLOCK, roots.size() - block * SPANNER_BLOCK);
+
+                         earliestArrivalBlock<SPANNER_BLOCK>(view, blockRoots, count, mode, worker.state, worker.scratch);
+                         markTrees<true>(view, blockRoots, count, mode, worker, workerBits[w]);
+                         latestDepartureBlock<SPANNER_BLOCK>(view, blockRoots, count, mode, worker.state, worker.scratch);
+                         markTrees<false>(view, blockRoots, count, mode, worker, workerBits[w]); });
+
+    mergeSpanner(view, pool, workerBits, spanner);
+}
+
+void mergeSpanner(const ContactView &view, ThreadPool &pool, const vector<vector<uint64_t>> &workerBits,
+                  TemporalSpanner &spanner)
+{
+    size_t words = (view.last + 63) / 64;
+    spanner.contacts.assign(words, 0);
+    pool.parallelFor((words + SPANNER_MERGE_WORDS - 1) / SPANNER_MERGE_WORDS, [&](size_t block, unsigned)
+                     {
+                         size_t end = min(words, (block + 1) * SPANNER_MERGE_WORDS);
+                         for (const vector<uint64_t> &bits : workerBits)
+                         {
+                             for (size_t w = block * SPANNER_MERGE_WORDS; w < end; w++)
+                             {
+                                 spanner.contacts[w] |= bits[w];
+                             }
+                         } });
+
+    // un arco dello spanner e' una coppia (from, to) con almeno un contatto acceso
+    vector<uint64_t> arcs;
+    for (size_t w = 0; w < words; w++)
+    {
+        for (uint64_t bits = spanner.contacts[w]; bits != 0; bits &= bits - 1)
+        {
+            const Contact &contact = view.contacts[w * 64 + __builtin_ctzll(bits)];
+            arcs.push_back((uint64_t(contact.from) << 32) | contact.to);
+        }
+    }
+    spanner.contactCount = arcs.size();
+    sort(arcs.begin(), arcs.end());
+    spanner.arcCount = unique(arcs.begin(), arcs.end()) - arcs.begin();
+
+    arcs.clear();
+    for (size_t i = view.first; i < view.last; i++)
+    {
+        arcs.push_back((uint64_t(view.contacts[i].from) << 32) | view.contacts[i].to);
+    }
+    spanner.originalContacts = arcs.size();
+    sort(arcs.begin(), arcs.end());
+    spanner.originalArcs = unique(arcs.begin(), arcs.end()) - arcs.begin();
+}
+
+TemporalStorage spannerStorage(const TemporalStorage &storage, const TemporalSpanner &spanner)
+{
+    vector<Contact> contacts;
+    contacts.reserve(spanner.contactCount);
+    for (size_t w = 0; w < spanner.contacts.size(); w++)
+    {
+        for (uint64_t bits = spanner.contacts[w]; bits != 0; bits &= bits - 1)
+        {
+            contacts.push_back(storage.contacts[w * 64 + __builtin_ctzll(bits)]);
+        }
+    }
+
+    TemporalStorage result(storage.directed);
+    result.names = storage.names;
+    result.build(move(contacts));
+    result.alive = storage.alive;
+    return result;
+}
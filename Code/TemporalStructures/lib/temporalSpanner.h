@@ -0,0 +1,48 @@
+#ifndef TEMPORALSPANNER_H
+#define TEMPORALSPANNER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "multiSourceScan.h"
+#include "threadPool.h"
+
+using namespace std;
+
+// numero di radici elaborate insieme da ogni task del pool (al piu' 32: una maschera per vertice)
+const size_t SPANNER_BLOCK = 32;
+
+// Spanner temporale come sottoinsieme dei contatti del flusso: il bit i di contacts e'
+// acceso se il contatto di indice assoluto i appartiene allo spanner.
+struct TemporalSpanner
+{
+    vector<uint64_t> contacts;
+    size_t contactCount = 0;
+    size_t arcCount = 0;
+
+    // dimensioni del grafo di partenza, per il confronto
+    size_t originalContacts = 0;
+    size_t originalArcs = 0;
+};
+
+// Unione degli alberi di earliest arrival da ogni radice e di latest departure verso ogni
+// radice: da ogni radice si raggiungono, con gli stessi tempi, tutti i vertici raggiungibili
+// nella vista, e lo stesso vale verso la radice. Con tutte le radici lo spanner conserva
+// quindi la raggiungibilita' temporale tra ogni coppia di vertici.
+// Le radici vengono distribuite sul pool a blocchi di SPANNER_BLOCK: i tempi del blocco si
+// calcolano con le scansioni multi-sorgente e gli alberi con una seconda scansione; ogni
+// worker accende i contatti dei propri alberi in un bitset privato e alla fine i bitset
+// vengono uniti parola per parola.
+void buildTemporalSpanner(const ContactView &view, const vector<uint32_t> &roots, ThreadPool &pool,
+                          JourneyMode mode, TemporalSpanner &spanner);
+
+// Unisce i bitset dei worker (uno per worker, di (view.last + 63) / 64 parole) in
+// spanner.contacts e calcola le dimensioni dello spanner e della vista
+void mergeSpanner(const ContactView &view, ThreadPool &pool, const vector<vector<uint64_t>> &workerBits,
+                  TemporalSpanner &spanner);
+
+// Storage con gli stessi vertici (e id) di storage ma solo i contatti dello spanner
+TemporalStorage spannerStorage(const TemporalStorage &storage, const TemporalSpanner &spanner);
+
+#endif
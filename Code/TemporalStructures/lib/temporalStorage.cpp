@@ -0,0 +1,419 @@
+#include "temporalStorage.h"
+
+#include <algorithm>
+
+using namespace std;
+
+uint32_t NameTable::intern(const string &name)
+{
+    auto found = this->ids.find(name);
+    if (found != this->ids.end())
+    {
+        return found->second;
+    }
+
+    uint32_t id = this->names.size();
+    this->names.push_back(name);
+    this->ids.emplace(name, id);
+    return id;
+}
+
+uint32_t NameTable::find(const string &name) const
+{
+    auto found = this->ids.find(name);
+    if (found == this->ids.end())
+    {
+        return NO_VERTEX;
+    }
+    return found->second;
+}
+
+const string &NameTable::name(uint32_t id) const
+{
+    return this->names[id];
+}
+
+size_t NameTable::size() const
+{
+    return this->names.size();
+}
+
+uint64_t contactDigest(const Contact &contact)
+{
+    // splitmix64 sulla concatenazione dei campi
+    uint64_t x = (uint64_t(contact.from) << 32 | contact.to) ^ (uint64_t(uint32_t(contact.time)) * 0x9e3779b97f4a7c15);
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111eb;
+    return x ^ (x >> 31);
+}
+
+bool contactBefore(const Contact &a, const Contact &b)
+{
+    if (a.time != b.time)
+        return a.time < b.time;
+    if (a.from != b.from)
+        return a.from < b.from;
+    return a.to < b.to;
+}
+
+TemporalStorage::TemporalStorage(bool directed)
+{
+    this->directed = directed;
+    this->offsets = {0};
+    this->timeOffsets = {0};
+    this->reverseOffsets = {0};
+}
+
+void TemporalStorage::build(vector<Contact> contacts)
+{
+    uint32_t n = this->names.size();
+    this->alive.resize(n, true);
+
+    if (!this->directed)
+    {
+        for (Contact &contact : contacts)
+        {
+            if (contact.from > contact.to)
+            {
+                swap(contact.from, contact.to);
+            }
+        }
+    }
+
+    // distribuzione per vertice di partenza in O(m), poi ordinamento delle sole righe
+    vector<size_t> rowStart(n + 1, 0);
+    for (const Contact &contact : contacts)
+    {
+        rowStart[contact.from + 1]++;
+    }
+    for (uint32_t u = 0; u < n; u++)
+    {
+        rowStart[u + 1] += rowStart[u];
+    }
+    vector<Contact> rows(contacts.size());
+    vector<size_t> rowFill(rowStart.begin(), rowStart.end() - 1);
+    for (const Contact &contact : contacts)
+    {
+        rows[rowFill[contact.from]++] = contact;
+    }
+    for (uint32_t u = 0; u < n; u++)
+    {
+        sort(rows.begin() + rowStart[u], rows.begin() + rowStart[u + 1],
+             [](const Contact &a, const Contact &b)
+             {
+                 if (a.to != b.to)
+                     return a.to < b.to;
+                 return a.time < b.time;
+             });
+    }
+    contacts.swap(rows);
+
+    this->offsets.assign(n + 1, 0);
+    this->neighbours.clear();
+    this->timeOffsets.assign(1, 0);
+    this->timestamps.clear();
+    this->timestamps.reserve(contacts.size());
+
+    for (size_t i = 0; i < contacts.size(); i++)
+    {
+        const Contact &contact = contacts[i];
+        if (i == 0 || contact.from != contacts[i - 1].from || contact.to != contacts[i - 1].to)
+        {
+            // inizia un nuovo arco: chiudo l'intervallo di timestamp del precedente
+            if (!this->neighbours.empty())
+            {
+                this->timeOffsets.push_back(this->timestamps.size());
+            }
+            this->neighbours.push_back(contact.to);
+            this->offsets[contact.from + 1]++;
+        }
+        this->timestamps.push_back(contact.time);
+    }
+    if (!this->neighbours.empty())
+    {
+        this->timeOffsets.push_back(this->timestamps.size());
+    }
+
+    for (uint32_t u = 0; u < n; u++)
+    {
+        this->offsets[u + 1] += this->offsets[u];
+    }
+
+    // i contatti sono gia' ordinati per (from, to): un ordinamento stabile sul solo
+    // tempo basta a ottenere l'ordine di contactBefore
+    stable_sort(contacts.begin(), contacts.end(), [](const Contact &a, const Contact &b)
+                { return a.time < b.time; });
+    this->contacts = move(contacts);
+    this->rehashContacts();
+    this->indexReverseArcs();
+}
+
+void TemporalStorage::rehashContacts()
+{
+    this->contactHash = 0;
+    for (const Contact &contact : this->contacts)
+    {
+        this->contactHash += contactDigest(contact);
+    }
+}
+
+uint32_t TemporalStorage::addVertex(const string &name)
+{
+    uint32_t id = this->names.intern(name);
+    if (id >= this->alive.size())
+    {
+        this->alive.push_back(true);
+        this->offsets.push_back(this->offsets.back());
+        this->reverseOffsets.push_back(this->reverseOffsets.back());
+    }
+    else
+    {
+        this->alive[id] = true;
+    }
+    return id;
+}
+
+void TemporalStorage::removeVertex(uint32_t vertex)
+{
+    // compatto in un solo passaggio tutti gli archi che toccano il vertice;
+    // l'id resta internato e viene riusato se il vertice viene riaggiunto
+    this->alive[vertex] = false;
+
+    this->contacts.erase(remove_if(this->contacts.begin(), this->contacts.end(),
+                                   [this, vertex](const Contact &contact)
+                                   {
+                                       bool removed = contact.from == vertex || contact.to == vertex;
+                                       this->contactHash -= removed ? contactDigest(contact) : 0;
+                                       return removed;
+                                   }),
+                         this->contacts.end());
+
+    uint32_t n = this->vertexCount();
+    vector<uint32_t> newOffsets(n + 1, 0);
+    uint32_t arcOut = 0;
+    uint32_t timeOut = 0;
+
+    for (uint32_t u = 0; u < n; u++)
+    {
+        for (uint32_t arc = this->offsets[u]; arc < this->offsets[u + 1]; arc++)
+        {
+            if (u == vertex || this->neighbours[arc] == vertex)
+            {
+                continue;
+            }
+
+            uint32_t tBegin = this->timeOffsets[arc];
+            uint32_t tEnd = this->timeOffsets[arc + 1];
+            this->neighbours[arcOut] = this->neighbours[arc];
+            this->timeOffsets[arcOut] = timeOut;
+            for (uint32_t t = tBegin; t < tEnd; t++)
+            {
+                this->timestamps[timeOut++] = this->timestamps[t];
+            }
+            arcOut++;
+        }
+        newOffsets[u + 1] = arcOut;
+    }
+
+    this->neighbours.resize(arcOut);
+    this->timeOffsets.resize(arcOut + 1);
+    this->timeOffsets[arcOut] = timeOut;
+    this->timestamps.resize(timeOut);
+    this->offsets = move(newOffsets);
+    this->indexReverseArcs();
+}
+
+bool TemporalStorage::isAlive(uint32_t vertex) const
+{
+    return vertex < this->alive.size() && this->alive[vertex];
+}
+
+uint32_t TemporalStorage::vertexCount() const
+{
+    return this->names.size();
+}
+
+size_t TemporalStorage::arcCount() const
+{
+    return this->neighbours.size();
+}
+
+uint32_t TemporalStorage::findArc(uint32_t start, uint32_t end) const
+{
+    if (!this->directed && start > end)
+    {
+        swap(start, end);
+    }
+    auto rowBegin = this->neighbours.begin() + this->offsets[start];
+    auto rowEnd = this->neighbours.begin() + this->offsets[start + 1];
+    auto found = lower_bound(rowBegin, rowEnd, end);
+    if (found == rowEnd || *found != end)
+    {
+        return NO_ARC;
+    }
+    return found - this->neighbours.begin();
+}
+
+void TemporalStorage::setArc(uint32_t start, uint32_t end, const vector<int> &times)
+{
+    if (!this->directed && start > end)
+    {
+        swap(start, end);
+    }
+    vector<int> sorted = times;
+    sort(sorted.begin(), sorted.end());
+
+    auto rowBegin = this->neighbours.begin() + this->offsets[start];
+    auto rowEnd = this->neighbours.begin() + this->offsets[start + 1];
+    auto position = lower_bound(rowBegin, rowEnd, end);
+    uint32_t arc = position - this->neighbours.begin();
+
+    if (position != rowEnd && *position == end)
+    {
+        // l'arco esiste gia': sostituisco i suoi timestamp
+        uint32_t tBegin = this->timeOffsets[arc];
+        uint32_t tEnd = this->timeOffsets[arc + 1];
+        this->eraseContacts(start, end, vector<int>(this->timestamps.begin() + tBegin, this->timestamps.begin() + tEnd));
+        this->insertContacts(start, end, sorted);
+        this->timestamps.erase(this->timestamps.begin() + tBegin, this->timestamps.begin() + tEnd);
+        this->timestamps.insert(this->timestamps.begin() + tBegin, sorted.begin(), sorted.end());
+
+        int64_t delta = (int64_t)sorted.size() - (int64_t)(tEnd - tBegin);
+        for (size_t i = arc + 1; i < this->timeOffsets.size(); i++)
+        {
+            this->timeOffsets[i] += delta;
+        }
+        return;
+    }
+
+    this->insertContacts(start, end, sorted);
+
+    uint32_t tBegin = this->timeOffsets[arc];
+    this->neighbours.insert(position, end);
+    this->timeOffsets.insert(this->timeOffsets.begin() + arc, tBegin);
+    this->timestamps.insert(this->timestamps.begin() + tBegin, sorted.begin(), sorted.end());
+    for (size_t i = arc + 1; i < this->timeOffsets.size(); i++)
+    {
+        this->timeOffsets[i] += sorted.size();
+    }
+    for (size_t u = start + 1; u < this->offsets.size(); u++)
+    {
+        this->offsets[u]++;
+    }
+    this->indexReverseArcs();
+}
+
+void TemporalStorage::removeArc(uint32_t start, uint32_t end)
+{
+    if (!this->directed && start > end)
+    {
+        swap(start, end);
+    }
+    uint32_t arc = this->findArc(start, end);
+    if (arc == NO_ARC)
+    {
+        return;
+    }
+
+    uint32_t tBegin = this->timeOffsets[arc];
+    uint32_t tEnd = this->timeOffsets[arc + 1];
+    this->eraseContacts(start, end, vector<int>(this->timestamps.begin() + tBegin, this->timestamps.begin() + tEnd));
+    this->timestamps.erase(this->timestamps.begin() + tBegin, this->timestamps.begin() + tEnd);
+    this->neighbours.erase(this->neighbours.begin() + arc);
+    this->timeOffsets.erase(this->timeOffsets.begin() + arc + 1);
+    for (size_t i = arc + 1; i < this->timeOffsets.size(); i++)
+    {
+        this->timeOffsets[i] -= tEnd - tBegin;
+    }
+    for (size_t u = start + 1; u < this->offsets.size(); u++)
+    {
+        this->offsets[u]--;
+    }
+    this->indexReverseArcs();
+}
+
+void TemporalStorage::indexReverseArcs()
+{
+    uint32_t n = this->vertexCount();
+    this->reverseOffsets.assign(n + 1, 0);
+    this->reverseNeighbours.clear();
+    this->reverseArcs.clear();
+    if (this->directed)
+    {
+        return;
+    }
+
+    for (uint32_t u = 0; u < n; u++)
+    {
+        for (uint32_t arc = this->offsets[u]; arc < this->offsets[u + 1]; arc++)
+        {
+            if (this->neighbours[arc] != u)
+            {
+                this->reverseOffsets[this->neighbours[arc] + 1]++;
+            }
+        }
+    }
+    for (uint32_t v = 0; v < n; v++)
+    {
+        this->reverseOffsets[v + 1] += this->reverseOffsets[v];
+    }
+
+    // scorrendo le righe in ordine di origine ogni lista resta ordinata per id del vicino
+    this->reverseNeighbours.resize(this->reverseOffsets[n]);
+    this->reverseArcs.resize(this->reverseOffsets[n]);
+    vector<uint32_t> fill(this->reverseOffsets.begin(), this->reverseOffsets.end() - 1);
+    for (uint32_t u = 0; u < n; u++)
+    {
+        for (uint32_t arc = this->offsets[u]; arc < this->offsets[u + 1]; arc++)
+        {
+            uint32_t v = this->neighbours[arc];
+            if (v != u)
+            {
+                this->reverseNeighbours[fill[v]] = u;
+                this->reverseArcs[fill[v]++] = arc;
+            }
+        }
+    }
+}
+
+void TemporalStorage::insertContacts(uint32_t start, uint32_t end, const vector<int> &sortedTimes)
+{
+    if (sortedTimes.size() == 1)
+    {
+        Contact contact = {start, end, sortedTimes[0]};
+        this->contacts.insert(upper_bound(this->contacts.begin(), this->contacts.end(), contact, contactBefore), contact);
+        this->contactHash += contactDigest(contact);
+        return;
+    }
+
+    // i nuovi contatti sono gia' ordinati: basta una fusione lineare
+    size_t middle = this->contacts.size();
+    for (int time : sortedTimes)
+    {
+        this->contacts.push_back({start, end, time});
+        this->contactHash += contactDigest(this->contacts.back());
+    }
+    inplace_merge(this->contacts.begin(), this->contacts.begin() + middle, this->contacts.end(), contactBefore);
+}
+
+void TemporalStorage::eraseContacts(uint32_t start, uint32_t end, const vector<int> &sortedTimes)
+{
+    if (sortedTimes.empty())
+    {
+        return;
+    }
+
+    // i contatti dell'arco cadono tutti nella finestra [primo timestamp, ultimo timestamp]
+    auto windowBegin = lower_bound(this->contacts.begin(), this->contacts.end(),
+                                   Contact{start, end, sortedTimes.front()}, contactBefore);
+    auto windowEnd = upper_bound(windowBegin, this->contacts.end(),
+                                 Contact{start, end, sortedTimes.back()}, contactBefore);
+    auto kept = remove_if(windowBegin, windowEnd,
+                          [this, start, end](const Contact &contact)
+                          {
+                              bool removed = contact.from == start && contact.to == end;
+                              this->contactHash -= removed ? contactDigest(contact) : 0;
+                              return removed;
+                          });
+    this->contacts.erase(kept, windowEnd);
+}
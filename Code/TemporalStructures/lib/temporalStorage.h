@@ -0,0 +1,127 @@
+#ifndef TEMPORALSTORAGE_H
+#define TEMPORALSTORAGE_H
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+// id riservati per indicare un vertice o un arco assente
+const uint32_t NO_VERTEX = numeric_limits<uint32_t>::max();
+const uint32_t NO_ARC = numeric_limits<uint32_t>::max();
+const uint32_t NO_CONTACT = numeric_limits<uint32_t>::max();
+
+// Tabella dei nomi: ogni nome di vertice viene internato una sola volta
+// in un id intero denso, usato da tutte le strutture interne.
+class NameTable
+{
+
+public:
+    vector<string> names;
+    unordered_map<string, uint32_t> ids;
+
+    uint32_t intern(const string &name);
+    uint32_t find(const string &name) const;
+    const string &name(uint32_t id) const;
+    size_t size() const;
+};
+
+// Contatto temporale (from, to, time) espresso con id interi
+struct Contact
+{
+    uint32_t from;
+    uint32_t to;
+    int time;
+};
+
+// ordine globale dei contatti: per tempo, poi per estremi
+bool contactBefore(const Contact &a, const Contact &b);
+
+// impronta a 64 bit di un contatto, sommata in TemporalStorage::contactHash
+uint64_t contactDigest(const Contact &contact);
+
+// Motore di memorizzazione del grafo temporale.
+// L'adiacenza e' in formato CSR: gli archi uscenti dal vertice u sono
+// neighbours[offsets[u] .. offsets[u + 1]), ordinati per id del vicino, e i
+// timestamp (ordinati) dell'arco a sono timestamps[timeOffsets[a] .. timeOffsets[a + 1]).
+// In parallelo viene mantenuto contacts, il flusso globale di tutti i contatti
+// ordinato secondo contactBefore: viene costruito una volta e aggiornato
+// incrementalmente, cosi' le query si limitano a scorrerlo.
+// In un grafo non orientato ogni arco e ogni contatto sono memorizzati una sola volta,
+// dal vertice con id minore a quello con id maggiore: le scansioni percorrono ogni
+// contatto in entrambe le direzioni e reverseArcs elenca, per ogni vertice v, gli archi
+// u -> v con u < v, cosi' i vicini di v si ottengono senza duplicare i timestamp.
+class TemporalStorage
+{
+
+public:
+    bool directed;
+
+    NameTable names;
+    vector<bool> alive;
+
+    vector<uint32_t> offsets;
+    vector<uint32_t> neighbours;
+    vector<uint32_t> timeOffsets;
+    vector<int> timestamps;
+
+    vector<Contact> contacts;
+    // somma (modulo 2^64) di contactDigest sui contatti del flusso, aggiornata da ogni
+    // modifica: identifica l'insieme dei contatti senza dipendere dall'ordine
+    uint64_t contactHash = 0;
+
+    // solo per i grafi non orientati: gli archi entranti in v da vertici con id minore sono
+    // reverseArcs[reverseOffsets[v] .. reverseOffsets[v + 1]), con origine in reverseNeighbours
+    vector<uint32_t> reverseOffsets;
+    vector<uint32_t> reverseNeighbours;
+    vector<uint32_t> reverseArcs;
+
+    TemporalStorage(bool directed = false);
+
+    // costruzione in blocco a partire dai contatti, raggruppati per arco
+    void build(vector<Contact> contacts);
+
+    uint32_t addVertex(const string &name);
+    void removeVertex(uint32_t vertex);
+    bool isAlive(uint32_t vertex) const;
+
+    uint32_t vertexCount() const;
+    size_t arcCount() const;
+
+    // nei grafi non orientati (start, end) e (end, start) indicano lo stesso arco
+    uint32_t findArc(uint32_t start, uint32_t end) const;
+    void setArc(uint32_t start, uint32_t end, const vector<int> &times);
+    void removeArc(uint32_t start, uint32_t end);
+
+    // chiama visit(vicino, arco) per ogni arco uscente da vertex, in ordine di id del vicino;
+    // nei grafi non orientati anche per gli archi memorizzati dal lato del vicino
+    template <typename Visit>
+    void forEachNeighbour(uint32_t vertex, Visit visit) const
+    {
+        if (!this->directed)
+        {
+            for (uint32_t i = this->reverseOffsets[vertex]; i < this->reverseOffsets[vertex + 1]; i++)
+            {
+                visit(this->reverseNeighbours[i], this->reverseArcs[i]);
+            }
+        }
+        for (uint32_t arc = this->offsets[vertex]; arc < this->offsets[vertex + 1]; arc++)
+        {
+            visit(this->neighbours[arc], arc);
+        }
+    }
+
+    // ricostruisce reverseArcs dopo una modifica dell'adiacenza (grafi non orientati)
+    void indexReverseArcs();
+    // ricalcola contactHash dopo aver riempito contacts direttamente
+    void rehashContacts();
+
+private:
+    void insertContacts(uint32_t start, uint32_t end, const vector<int> &sortedTimes);
+    void eraseContacts(uint32_t start, uint32_t end, const vector<int> &sortedTimes);
+};
+
+#endif
@@ -0,0 +1,377 @@
+#include "temporalStream.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+using namespace std;
+
+// il log viene compattato quando i contatti scartati in testa sono almeno questi e
+// almeno la meta' del log: ogni contatto viene spostato al piu' una volta per scarto
+const size_t STREAM_COMPACT = 4096;
+
+TemporalStream::TemporalStream(bool directed, JourneyMode mode, int64_t horizon, bool trackReachability)
+{
+    if (horizon < 0)
+    {
+        throw invalid_argument("l'orizzonte di conservazione non puo' essere negativo");
+    }
+    this->directed = directed;
+    this->mode = mode;
+    this->horizon = horizon;
+    this->trackReachability = trackReachability;
+}
+
+uint32_t TemporalStream::vertexCount() const
+{
+    return this->names.size();
+}
+
+uint32_t TemporalStream::addVertex(const string &name)
+{
+    uint32_t before = this->vertexCount();
+    uint32_t id = this->names.intern(name);
+    if (this->vertexCount() == before)
+    {
+        return id;
+    }
+
+    for (vector<int> &times : this->ea)
+    {
+        times.push_back(numeric_limits<int>::max());
+    }
+    this->savedRow.push_back(NO_VERTEX);
+    if (this->trackReachability)
+    {
+        // le righe raddoppiano di larghezza quando si esauriscono i bit
+        if (this->vertexCount() > this->reachWords * 64)
+        {
+            this->reachWords = max<size_t>(1, 2 * this->reachWords);
+            for (vector<uint64_t> &row : this->reach)
+            {
+                row.resize(this->reachWords, 0);
+            }
+            for (vector<uint64_t> &row : this->saved)
+            {
+                row.resize(this->reachWords, 0);
+            }
+        }
+        this->reach.emplace_back(this->reachWords, 0);
+        this->reach[id][id / 64] |= uint64_t(1) << (id % 64);
+    }
+    return id;
+}
+
+void TemporalStream::append(const string &from, const string &to, int time)
+{
+    uint32_t fromId = this->addVertex(from);
+    uint32_t toId = this->addVertex(to);
+    this->append(fromId, toId, time);
+}
+
+void TemporalStream::append(uint32_t from, uint32_t to, int time)
+{
+    if (time < this->latest)
+    {
+        throw invalid_argument("contatto fuori ordine: il tempo precede l'ultimo ricevuto");
+    }
+    if (!this->directed && from > to)
+    {
+        swap(from, to);
+    }
+    if (this->log.size() == this->head || time != this->latest)
+    {
+        this->closeGroup();
+        this->latest = time;
+        this->retain();
+        this->groupStart = this->log.size();
+    }
+    this->log.push_back({from, to, time});
+    if (this->stale)
+    {
+        return;
+    }
+
+    for (vector<int> &times : this->ea)
+    {
+        this->relaxEarliest(times, from, to, time);
+        if (!this->directed)
+        {
+            this->relaxEarliest(times, to, from, time);
+        }
+    }
+    if (this->trackReachability)
+    {
+        this->relaxReach(from, to);
+        if (!this->directed)
+        {
+            this->relaxReach(to, from);
+        }
+    }
+}
+
+// Chiude il gruppo di contatti con tempo latest: le righe salvate non servono piu'
+void TemporalStream::closeGroup()
+{
+    for (uint32_t v : this->savedVertices)
+    {
+        this->savedRow[v] = NO_VERTEX;
+    }
+    this->savedVertices.clear();
+}
+
+void TemporalStream::retain()
+{
+    while (this->head < this->log.size() && int64_t(this->latest) - this->log[this->head].time > this->horizon)
+    {
+        this->head++;
+        this->stale = true;
+    }
+    if (this->head >= STREAM_COMPACT && 2 * this->head >= this->log.size())
+    {
+        this->log.erase(this->log.begin(), this->log.begin() + this->head);
+        this->head = 0;
+    }
+}
+
+// Ricostruisce nomi, ea e reach dai soli contatti conservati: tiene i vertici che vi
+// compaiono e le sorgenti osservate, rinumerati nello stesso ordine relativo (i contatti
+// non orientati restano memorizzati dall'id minore), e riaccoda i contatti a uno stato
+// vuoto. Nessun contatto riaccodato esce dall'orizzonte, quindi retain non scarta nulla.
+void TemporalStream::refresh()
+{
+    if (!this->stale)
+    {
+        return;
+    }
+    this->closeGroup();
+
+    vector<uint32_t> renamed(this->vertexCount(), NO_VERTEX);
+    for (size_t i = this->head; i < this->log.size(); i++)
+    {
+        renamed[this->log[i].from] = 0;
+        renamed[this->log[i].to] = 0;
+    }
+    for (uint32_t source : this->sources)
+    {
+        renamed[source] = 0;
+    }
+    NameTable names;
+    for (uint32_t v = 0; v < renamed.size(); v++)
+    {
+        if (renamed[v] != NO_VERTEX)
+        {
+            renamed[v] = names.intern(this->names.name(v));
+        }
+    }
+    vector<Contact> retained;
+    retained.reserve(this->log.size() - this->head);
+    for (size_t i = this->head; i < this->log.size(); i++)
+    {
+        const Contact &contact = this->log[i];
+        retained.push_back({renamed[contact.from], renamed[contact.to], contact.time});
+    }
+
+    this->names = NameTable();
+    this->log.clear();
+    this->head = 0;
+    this->groupStart = 0;
+    this->latest = numeric_limits<int>::min();
+    this->ea.clear();
+    this->reachWords = 0;
+    this->reach.clear();
+    this->savedRow.clear();
+    this->saved.clear();
+    this->stale = false;
+    for (uint32_t v = 0; v < names.size(); v++)
+    {
+        this->addVertex(names.name(v));
+    }
+    for (uint32_t &source : this->sources)
+    {
+        source = renamed[source];
+        this->ea.emplace_back(this->vertexCount(), numeric_limits<int>::max());
+        this->ea.back()[source] = numeric_limits<int>::min();
+    }
+    for (const Contact &contact : retained)
+    {
+        this->append(contact.from, contact.to, contact.time);
+    }
+}
+
+// In modalita' non stretta un vertice appena raggiunto al tempo latest puo' usare anche i
+// contatti del gruppo arrivati prima di lui: si ririlassano quelli che partono da vertex
+// e, a catena, da ogni vertice che migliora
+template <typename Relax>
+void TemporalStream::propagateGroup(uint32_t vertex, Relax relax)
+{
+    this->queue.assign(1, vertex);
+    for (size_t q = 0; q < this->queue.size(); q++)
+    {
+        uint32_t tail = this->queue[q];
+        for (size_t i = this->groupStart; i < this->log.size(); i++)
+        {
+            const Contact &contact = this->log[i];
+            uint32_t head = NO_VERTEX;
+            if (contact.from == tail)
+            {
+                head = contact.to;
+            }
+            else if (!this->directed && contact.to == tail)
+            {
+                head = contact.from;
+            }
+            if (head != NO_VERTEX && head != tail && relax(tail, head))
+            {
+                this->queue.push_back(head);
+            }
+        }
+    }
+}
+
+void TemporalStream::relaxEarliest(vector<int> &times, uint32_t tail, uint32_t head, int time)
+{
+    bool strict = this->mode == JourneyMode::Strict;
+    auto relax = [&](uint32_t u, uint32_t v)
+    {
+        bool usable = strict ? times[u] < time : times[u] <= time;
+        if (usable && time < times[v])
+        {
+            times[v] = time;
+            return true;
+        }
+        return false;
+    };
+
+    // in modalita' stretta un vertice raggiunto al tempo latest non riparte nello stesso gruppo
+    if (tail != head && relax(tail, head) && !strict)
+    {
+        this->propagateGroup(head, relax);
+    }
+}
+
+void TemporalStream::relaxReach(uint32_t tail, uint32_t head)
+{
+    if (tail == head)
+    {
+        return;
+    }
+
+    if (this->mode == JourneyMode::NonStrict)
+    {
+        auto relax = [this](uint32_t u, uint32_t v)
+        {
+            bool changed = false;
+            for (size_t w = 0; w < this->reachWords; w++)
+            {
+                uint64_t merged = this->reach[v][w] | this->reach[u][w];
+                changed |= merged != this->reach[v][w];
+                this->reach[v][w] = merged;
+            }
+            return changed;
+        };
+        if (relax(tail, head))
+        {
+            this->propagateGroup(head, relax);
+        }
+        return;
+    }
+
+    // modalita' stretta: tail contribuisce con chi lo raggiungeva prima del gruppo corrente
+    const vector<uint64_t> &from = this->savedRow[tail] != NO_VERTEX ? this->saved[this->savedRow[tail]] : this->reach[tail];
+    bool changes = false;
+    for (size_t w = 0; w < this->reachWords && !changes; w++)
+    {
+        changes = (from[w] & ~this->reach[head][w]) != 0;
+    }
+    if (!changes)
+    {
+        return;
+    }
+    if (this->savedRow[head] == NO_VERTEX)
+    {
+        this->savedRow[head] = this->savedVertices.size();
+        if (this->saved.size() == this->savedVertices.size())
+        {
+            this->saved.emplace_back();
+        }
+        this->saved[this->savedRow[head]] = this->reach[head];
+        this->savedVertices.push_back(head);
+    }
+    // from puo' essere stata invalidata da emplace_back: si rilegge
+    const vector<uint64_t> &source = this->savedRow[tail] != NO_VERTEX ? this->saved[this->savedRow[tail]] : this->reach[tail];
+    for (size_t w = 0; w < this->reachWords; w++)
+    {
+        this->reach[head][w] |= source[w];
+    }
+}
+
+void TemporalStream::watch(const string &source)
+{
+    this->refresh();
+    uint32_t id = this->addVertex(source);
+    if (find(this->sources.begin(), this->sources.end(), id) != this->sources.end())
+    {
+        return;
+    }
+    this->sources.push_back(id);
+    this->ea.emplace_back();
+    earliestArrivalScan(this->window(), id, this->mode, this->ea.back(), nullptr);
+}
+
+ContactView TemporalStream::window()
+{
+    this->refresh();
+    return {this->log.data(), this->head, this->log.size(), this->vertexCount(), !this->directed};
+}
+
+TemporalStorage TemporalStream::storage()
+{
+    this->refresh();
+    TemporalStorage result(this->directed);
+    result.names = this->names;
+    result.build(vector<Contact>(this->log.begin() + this->head, this->log.end()));
+    return result;
+}
+
+unordered_map<string, int> TemporalStream::earliestTime(const string &source)
+{
+    this->refresh();
+    uint32_t id = this->names.find(source);
+    vector<int> scanned;
+    const vector<int> *times = &scanned;
+    auto watched = find(this->sources.begin(), this->sources.end(), id);
+    if (id != NO_VERTEX && watched != this->sources.end())
+    {
+        times = &this->ea[watched - this->sources.begin()];
+    }
+    else
+    {
+        earliestArrivalScan(this->window(), id, this->mode, scanned, nullptr);
+    }
+
+    unordered_map<string, int> namedMap;
+    for (uint32_t v = 0; v < this->vertexCount(); v++)
+    {
+        namedMap[this->names.name(v)] = (*times)[v];
+    }
+    namedMap[source] = numeric_limits<int>::min();
+    return namedMap;
+}
+
+bool TemporalStream::reaches(const string &from, const string &to)
+{
+    this->refresh();
+    uint32_t fromId = this->names.find(from);
+    uint32_t toId = this->names.find(to);
+    if (fromId == NO_VERTEX || toId == NO_VERTEX)
+    {
+        return false;
+    }
+    if (this->trackReachability)
+    {
+        return (this->reach[toId][fromId / 64] >> (fromId % 64)) & 1;
+    }
+    vector<int> times;
+    earliestArrivalScan(this->window(), fromId, this->mode, times, nullptr);
+    return times[toId] != numeric_limits<int>::max();
+}
@@ -0,0 +1,95 @@
+#ifndef TEMPORALSTREAM_H
+#define TEMPORALSTREAM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "temporalScan.h"
+
+using namespace std;
+
+// Ingestione in streaming di contatti che arrivano in ordine di tempo non decrescente.
+// Ogni contatto viene accodato al log (gia' ordinato per tempo) in tempo costante
+// ammortizzato e aggiorna subito lo stato delle query registrate:
+// - l'earliest arrival da ogni sorgente osservata con watch;
+// - se trackReachability, per ogni vertice v l'insieme (bitset) dei vertici che lo raggiungono.
+// Il log conserva solo i contatti con tempo non inferiore all'ultimo tempo ricevuto meno
+// horizon, e ogni query descrive esattamente quella finestra. Quando dei contatti escono
+// dall'orizzonte lo stato diventa stale e gli append smettono di aggiornarlo: la prima
+// query successiva (earliestTime, reaches, watch, window, storage) lo ricostruisce dai
+// contatti conservati, scartando i vertici senza contatti conservati che non sono
+// sorgenti osservate. Nomi, righe ea e bitset reach restano cosi' proporzionali ai vertici
+// della finestra; gli id dei vertici vengono rinumerati (nello stesso ordine relativo),
+// quindi quelli restituiti da addVertex valgono solo fino alla query successiva.
+// Un grafo non orientato memorizza ogni contatto dal vertice con id minore, come TemporalStorage.
+class TemporalStream
+{
+
+public:
+    bool directed;
+    JourneyMode mode;
+    int64_t horizon;
+    bool trackReachability;
+
+    NameTable names;
+    // contatti conservati: log[head .. log.size())
+    vector<Contact> log;
+    size_t head = 0;
+    int latest = numeric_limits<int>::min();
+
+    // ea[i][v]: earliest arrival in v dalla sorgente sources[i]
+    vector<uint32_t> sources;
+    vector<vector<int>> ea;
+
+    // reach[v]: bit u acceso se u raggiunge v (ogni vertice raggiunge se stesso)
+    size_t reachWords = 0;
+    vector<vector<uint64_t>> reach;
+
+    TemporalStream(bool directed = false, JourneyMode mode = JourneyMode::NonStrict,
+                   int64_t horizon = numeric_limits<int64_t>::max(), bool trackReachability = false);
+
+    uint32_t addVertex(const string &name);
+    uint32_t vertexCount() const;
+
+    // accoda il contatto; invalid_argument se time e' minore dell'ultimo tempo ricevuto
+    void append(const string &from, const string &to, int time);
+    void append(uint32_t from, uint32_t to, int time);
+
+    // da qui in poi mantiene l'earliest arrival da source sui contatti conservati
+    void watch(const string &source);
+
+    // vista sui contatti conservati, utilizzabile con tutte le scansioni
+    ContactView window();
+    // storage con i vertici e i contatti conservati
+    TemporalStorage storage();
+
+    // earliest arrival da source: mantenuto se osservata, altrimenti sui contatti conservati
+    unordered_map<string, int> earliestTime(const string &source);
+    // con trackReachability dallo stato mantenuto, altrimenti sui contatti conservati
+    bool reaches(const string &from, const string &to);
+
+private:
+    // dei contatti sono usciti dall'orizzonte dopo l'ultima ricostruzione dello stato
+    bool stale = false;
+    // inizio del gruppo di contatti con tempo latest nel log
+    size_t groupStart = 0;
+    // righe di reach come erano prima del gruppo corrente (modalita' stretta)
+    vector<uint32_t> savedRow;
+    vector<vector<uint64_t>> saved;
+    vector<uint32_t> savedVertices;
+    vector<uint32_t> queue;
+
+    void closeGroup();
+    void retain();
+    void refresh();
+    void relaxEarliest(vector<int> &times, uint32_t tail, uint32_t head, int time);
+    void relaxReach(uint32_t tail, uint32_t head);
+    template <typename Relax>
+    void propagateGroup(uint32_t vertex, Relax relax);
+};
+
+#endif
@@ -1,4 +1,5 @@
 #include "temporalStructures.h"
+#include "queryWorkspace.h"
 
 using namespace std;
 
@@ -16,24 +17,96 @@ Edge::Edge(string start, string end)
     this->timestamps = {};
 }
 
-TemporalTree::TemporalTree(string root)
+TemporalTree::TemporalTree(const NameTable &names, string root, uint32_t vertexCount)
 {
     this->root = root;
-    this->setOfNodes.insert(root);
+    this->rootId = names.find(root);
+    this->parent.assign(vertexCount, NO_VERTEX);
+    this->time.assign(vertexCount, 0);
+    this->contact.assign(vertexCount, NO_CONTACT);
 }
 
-TemporalTree::TemporalTree(vector<Edge> edges)
+bool TemporalTree::contains(uint32_t node) const
 {
-    this->root = edges[0].start;
-    for (const auto &[start, end, timestamps] : edges)
+    return node != NO_VERTEX && (node == this->rootId || (node < this->parent.size() && this->parent[node] != NO_VERTEX));
+}
+
+void TemporalTree::copyNames(const NameTable &graphNames)
+{
+    this->names.assign(this->parent.size(), string());
+    this->ids.clear();
+    for (uint32_t node = 0; node < this->parent.size(); node++)
+    {
+        if (this->contains(node))
+        {
+            this->names[node] = graphNames.name(node);
+            this->ids[this->names[node]] = node;
+        }
+    }
+}
+
+uint32_t TemporalTree::find(const string &node) const
+{
+    auto found = this->ids.find(node);
+    return found == this->ids.end() ? NO_VERTEX : found->second;
+}
+
+bool TemporalTree::contains(const string &node) const
+{
+    return this->contains(this->find(node));
+}
+
+size_t TemporalTree::size() const
+{
+    size_t count = this->rootId != NO_VERTEX;
+    for (uint32_t father : this->parent)
     {
-        this->tree[start][end] = timestamps;
-        this->fatherMap[end] = start;
-        this->setOfNodes.insert(end);
+        count += father != NO_VERTEX;
     }
+    return count;
 }
 
-void TemporalTree::printTreeHelper(const string &node, string prefix, bool isLast)
+void TemporalTree::setParent(uint32_t node, uint32_t father, int time, uint32_t contact)
+{
+    this->parent[node] = father;
+    this->time[node] = time;
+    this->contact[node] = contact;
+    this->indexed = false;
+    TEMPORAL_COUNT(treeUpdates, 1);
+}
+
+void TemporalTree::indexChildren()
+{
+    if (this->indexed)
+    {
+        return;
+    }
+    uint32_t n = this->parent.size();
+    this->childOffsets.assign(n + 1, 0);
+    for (uint32_t father : this->parent)
+    {
+        if (father != NO_VERTEX)
+        {
+            this->childOffsets[father + 1]++;
+        }
+    }
+    for (uint32_t v = 0; v < n; v++)
+    {
+        this->childOffsets[v + 1] += this->childOffsets[v];
+    }
+    this->children.resize(this->childOffsets[n]);
+    vector<uint32_t> next(this->childOffsets.begin(), this->childOffsets.end() - 1);
+    for (uint32_t v = 0; v < n; v++)
+    {
+        if (this->parent[v] != NO_VERTEX)
+        {
+            this->children[next[this->parent[v]]++] = v;
+        }
+    }
+    this->indexed = true;
+}
+
+void TemporalTree::printTreeHelper(uint32_t node, string prefix, bool isLast)
 {
     cout << prefix;
 
@@ -42,26 +115,20 @@ void TemporalTree::printTreeHelper(const string &node, string prefix, bool isLas
         cout << (isLast ? "\u2514\u2500\u2500 " : "\u251c\u2500\u2500 ");
     }
 
-    cout << node;
+    cout << this->names[node];
 
-    // se il nodo ha figli, mostro anche i timestamp degli archi
-    if (tree.find(node) != tree.end())
+    // se il nodo ha figli, mostro anche i tempi dei contatti
+    vector<uint32_t> nodeChildren;
+    this->forEachChild(node, [&](uint32_t child)
+                       { nodeChildren.push_back(child); });
+    if (!nodeChildren.empty())
     {
         cout << " (";
-        bool first = true;
-        for (auto &[child, timestamps] : tree[node])
+        for (size_t i = 0; i < nodeChildren.size(); i++)
         {
-            if (!first)
+            if (i > 0)
                 cout << ", ";
-            cout << child << ": [";
-            for (size_t i = 0; i < timestamps.size(); i++)
-            {
-                cout << timestamps[i];
-                if (i < timestamps.size() - 1)
-                    cout << ", ";
-            }
-            cout << "]";
-            first = false;
+            cout << this->names[nodeChildren[i]] << ": [" << this->time[nodeChildren[i]] << "]";
         }
         cout << ")";
     }
@@ -69,329 +136,776 @@ void TemporalTree::printTreeHelper(const string &node, string prefix, bool isLas
     cout << endl;
 
     // ricorsione sui figli
-    if (tree.find(node) != tree.end())
+    for (size_t i = 0; i < nodeChildren.size(); i++)
     {
-        auto &children = tree[node];
-        size_t i = 0, n = children.size();
-        for (auto &[child, _] : children)
-        {
-            printTreeHelper(child, prefix + (isLast ? "    " : "\u2502   "), i == n - 1);
-            i++;
-        }
+        printTreeHelper(nodeChildren[i], prefix + (isLast ? "    " : "\u2502   "), i == nodeChildren.size() - 1);
     }
 }
 
 void TemporalTree::printTree()
 {
     cout << "Temporal Tree (root = " << root << ")" << endl;
-    printTreeHelper(root, "", true);
+    if (this->rootId == NO_VERTEX)
+    {
+        cout << root << endl;
+        return;
+    }
+    printTreeHelper(this->rootId, "", true);
 }
 
-void TemporalTree::addEdge(Edge newEdge)
+vector<uint32_t> TemporalTree::pruneSubtrees(const vector<uint32_t> &roots)
 {
-    this->setOfNodes.insert(newEdge.end);
-    this->fatherMap[newEdge.end] = newEdge.start;
-    this->tree[newEdge.start][newEdge.end] = newEdge.timestamps;
-}
+    vector<uint32_t> pruned;
+    auto detach = [this, &pruned](uint32_t node)
+    {
+        this->parent[node] = NO_VERTEX;
+        this->time[node] = 0;
+        this->contact[node] = NO_CONTACT;
+        pruned.push_back(node);
+    };
 
-void TemporalTree::removeNode(string nodeToDelete)
-{
-    if (this->tree[nodeToDelete].size() != 0)
+    for (uint32_t root : roots)
     {
-        vector<string> children;
-        for (const auto &[childToDelete, _] : this->tree[nodeToDelete])
+        // una radice gia' rimossa da un sottoalbero precedente del lotto non conta piu'
+        if (!this->contains(root))
         {
-            children.push_back(childToDelete);
+            continue;
         }
-        for (string childToDelete : children)
+        if (root == this->rootId)
         {
-            removeNode(childToDelete);
+            this->rootId = NO_VERTEX;
+        }
+        // pruned fa anche da coda della visita
+        size_t next = pruned.size();
+        detach(root);
+        for (; next < pruned.size(); next++)
+        {
+            this->forEachChild(pruned[next], detach);
         }
     }
-    this->setOfNodes.erase(nodeToDelete);
-    string father = this->fatherMap[nodeToDelete];
-    this->tree[father].erase(nodeToDelete);
+    return pruned;
 }
 
-vector<Edge> TemporalGraph::edgeStream(string source, bool reverse)
+void TemporalTree::removeNode(string nodeToDelete)
+{
+    this->pruneSubtrees({this->find(nodeToDelete)});
+}
+
+vector<Edge> TemporalGraph::edgeStream(string source, bool reverse) const
 {
-    set<vector<string>> visited;
     vector<Edge> stream;
+    for (uint32_t index : this->edgeStream(source, reverse, threadWorkspace()))
+    {
+        const Contact &contact = this->storage.contacts[index];
+        stream.push_back({this->storage.names.name(contact.from), this->storage.names.name(contact.to), {contact.time}});
+    }
+    return stream;
+}
 
-    vector<Edge> stack;
+TemporalGraph::TemporalGraph(vector<Edge> edgesList, bool directed) : storage(directed)
+{
+    // un arco ripetuto sovrascrive i timestamp delle occorrenze precedenti; nei grafi
+    // non orientati (u, v) e (v, u) sono lo stesso arco
+    unordered_map<uint64_t, size_t> lastOccurrence;
+    vector<uint32_t> startIds(edgesList.size());
+    vector<uint32_t> endIds(edgesList.size());
+    auto arcKey = [directed](uint64_t start, uint64_t end)
+    {
+        return directed ? (start << 32) | end : (min(start, end) << 32) | max(start, end);
+    };
 
-    for (const auto &[end, timestamp] : this->graph[source])
+    for (size_t i = 0; i < edgesList.size(); i++)
     {
-        stack.push_back({source, end, timestamp});
+        startIds[i] = this->storage.addVertex(edgesList[i].start);
+        endIds[i] = this->storage.addVertex(edgesList[i].end);
+        lastOccurrence[arcKey(startIds[i], endIds[i])] = i;
     }
 
-    while (stack.size() != 0)
+    vector<Contact> contacts;
+    vector<size_t> emptyEdges;
+    for (size_t i = 0; i < edgesList.size(); i++)
     {
-        Edge currentEdge = stack[stack.size() - 1];
-        stack.pop_back();
-
-        if (visited.find({currentEdge.start, currentEdge.end}) == visited.end())
+        if (lastOccurrence[arcKey(startIds[i], endIds[i])] != i)
         {
-            visited.insert({currentEdge.start, currentEdge.end});
-            for (int i = 0; i < currentEdge.timestamps.size(); i++)
-            {
-                stream.push_back({currentEdge.start, currentEdge.end, {currentEdge.timestamps[i]}});
-            }
+            continue;
+        }
 
-            for (const auto &[neighbour, timestamp] : this->graph[currentEdge.end])
-            {
-                stack.push_back({currentEdge.end, neighbour, timestamp});
-            }
+        for (int timestamp : edgesList[i].timestamps)
+        {
+            contacts.push_back({startIds[i], endIds[i], timestamp});
+        }
+        if (edgesList[i].timestamps.empty())
+        {
+            emptyEdges.push_back(i);
         }
     }
-    if (!reverse)
+    this->storage.build(contacts);
+
+    // gli archi senza timestamp non generano contatti ma restano nell'adiacenza
+    for (size_t i : emptyEdges)
     {
-        stable_sort(stream.begin(), stream.end(),
-                    [](const Edge &a, const Edge &b)
-                    {
-                        return a.timestamps[0] < b.timestamps[0];
-                    });
+        this->storage.setArc(startIds[i], endIds[i], {});
     }
-    else
+}
+
+TemporalGraph::TemporalGraph(TemporalStorage storage)
+{
+    this->storage = move(storage);
+}
+
+vector<string> TemporalGraph::nodes() const
+{
+    vector<string> nodes;
+    for (uint32_t u = 0; u < this->storage.vertexCount(); u++)
     {
-        stable_sort(stream.begin(), stream.end(),
-                    [](const Edge &a, const Edge &b)
-                    {
-                        return a.timestamps[0] > b.timestamps[0];
-                    });
+        if (this->storage.isAlive(u))
+        {
+            nodes.push_back(this->storage.names.name(u));
+        }
     }
+    return nodes;
+}
 
-    return stream;
+template <typename Times>
+static unordered_map<string, typename Times::value_type> namedTimesOf(const TemporalStorage &storage, const Times &times)
+{
+    TEMPORAL_PHASE("namedTimes");
+    unordered_map<string, typename Times::value_type> namedMap;
+    for (uint32_t u = 0; u < storage.vertexCount(); u++)
+    {
+        if (storage.isAlive(u))
+        {
+            namedMap[storage.names.name(u)] = times[u];
+        }
+    }
+    return namedMap;
+}
+
+unordered_map<string, int> TemporalGraph::namedTimes(const vector<int> &times) const
+{
+    return namedTimesOf(this->storage, times);
 }
 
-TemporalGraph::TemporalGraph(vector<Edge> edgesList)
+unordered_map<string, int> TemporalGraph::namedTimes(const pmr::vector<int> &times) const
 {
-    for (int i = 0; i < edgesList.size(); i++)
+    return namedTimesOf(this->storage, times);
+}
+
+TemporalTree TemporalGraph::parentTree(string root, vector<uint32_t> parentContact, bool reverse) const
+{
+    TEMPORAL_PHASE("parentTree");
+    // il padre si raggiunge ripercorrendo il contatto padre contro il verso della scansione
+    TemporalTree tree(this->storage.names, root, 0);
+    ContactView view = makeContactView(this->storage);
+    tree.contact = move(parentContact);
+    tree.parent.resize(tree.contact.size(), NO_VERTEX);
+    tree.time.resize(tree.contact.size(), 0);
+    for (uint32_t node = 0; node < tree.contact.size(); node++)
     {
-        string startNode = edgesList[i].start;
-        string endNode = edgesList[i].end;
-        this->setOfNodes.insert(startNode);
-        this->setOfNodes.insert(endNode);
+        if (tree.contact[node] != NO_CONTACT)
+        {
+            const Contact &contact = this->storage.contacts[tree.contact[node]];
+            tree.parent[node] = contactHead(view, contact, node, reverse);
+            tree.time[node] = contact.time;
+            TEMPORAL_COUNT(treeUpdates, 1);
+        }
+    }
+    tree.copyNames(this->storage.names);
+    return tree;
+}
 
-        this->graph[startNode][endNode] = edgesList[i].timestamps;
-        this->graph[endNode][startNode] = edgesList[i].timestamps;
+// Copia in un TemporalTree l'albero lasciato in workspace da una query sugli alberi
+TemporalTree TemporalGraph::workspaceTree(string root, const QueryWorkspace &workspace) const
+{
+    TemporalTree tree(this->storage.names, root, 0);
+    tree.parent.assign(workspace.parent.begin(), workspace.parent.end());
+    tree.contact.assign(workspace.parentContact.begin(), workspace.parentContact.end());
+    tree.time.assign(tree.contact.size(), 0);
+    for (uint32_t node = 0; node < tree.contact.size(); node++)
+    {
+        if (tree.contact[node] != NO_CONTACT)
+        {
+            tree.time[node] = this->storage.contacts[tree.contact[node]].time;
+        }
     }
+    tree.copyNames(this->storage.names);
+    return tree;
 }
 
-void TemporalGraph::printGraph()
+unordered_map<string, vector<array<int, 2>>> TemporalGraph::namedProfile(const TemporalProfile &profile) const
 {
-    for (const auto &[from, neighbors] : graph)
+    unordered_map<string, vector<array<int, 2>>> namedMap;
+    for (uint32_t u = 0; u < this->storage.vertexCount(); u++)
     {
-        cout << from << " :" << endl;
-        for (const auto &[to, times] : neighbors)
+        if (!this->storage.isAlive(u))
+        {
+            continue;
+        }
+        vector<array<int, 2>> &pairs = namedMap[this->storage.names.name(u)];
+        for (uint32_t i = profile.offsets[u]; i < profile.offsets[u + 1]; i++)
         {
-            cout << "   -> " << to << " : ";
-            for (int t : times)
-                cout << t << ", ";
-            cout << endl;
+            pairs.push_back({profile.entries[i].departure, profile.entries[i].arrival});
         }
     }
+    return namedMap;
 }
 
-void TemporalGraph::addNode(string newNode, vector<string> neighbours, vector<vector<int>> timestamps)
+void TemporalGraph::printGraph() const
 {
+    const TemporalStorage &storage = this->storage;
+    for (uint32_t from = 0; from < storage.vertexCount(); from++)
+    {
+        if (!storage.isAlive(from))
+        {
+            continue;
+        }
+        cout << storage.names.name(from) << " :" << endl;
+        storage.forEachNeighbour(from, [&storage](uint32_t neighbour, uint32_t arc)
+                                 {
+                                     cout << "   -> " << storage.names.name(neighbour) << " : ";
+                                     for (uint32_t t = storage.timeOffsets[arc]; t < storage.timeOffsets[arc + 1]; t++)
+                                         cout << storage.timestamps[t] << ", ";
+                                     cout << endl; });
+    }
+}
 
-    this->setOfNodes.insert(newNode);
+// timestamp attuali dell'arco (start, end), vuoto se l'arco non esiste
+static vector<int> arcTimes(const TemporalStorage &storage, uint32_t start, uint32_t end)
+{
+    uint32_t arc = storage.findArc(start, end);
+    if (arc == NO_ARC)
+    {
+        return {};
+    }
+    return vector<int>(storage.timestamps.begin() + storage.timeOffsets[arc],
+                       storage.timestamps.begin() + storage.timeOffsets[arc + 1]);
+}
 
-    for (int i = 0; i < neighbours.size(); i++)
+void TemporalGraph::setMonitoredArc(uint32_t start, uint32_t end, const vector<int> &timestamps)
+{
+    vector<int> oldTimes = this->monitor ? arcTimes(this->storage, start, end) : vector<int>();
+    this->storage.setArc(start, end, timestamps);
+    if (this->monitor)
     {
-        this->graph[newNode][neighbours[i]] = timestamps[i];
-        this->graph[neighbours[i]][newNode] = timestamps[i];
+        this->monitor->arcChanged(this->storage, start, end, oldTimes);
     }
 }
 
-void TemporalGraph::removeNode(string delNode)
+void TemporalGraph::addNode(string newNode, vector<string> neighbours, vector<vector<int>> timestamps)
 {
-    this->setOfNodes.erase(delNode);
-    vector<string> neighbourToDel;
+    uint32_t newId = this->storage.addVertex(newNode);
+    if (this->monitor)
+    {
+        this->monitor->resize(this->storage);
+    }
 
-    for (auto [neighbour, _] : this->graph[delNode])
+    for (int i = 0; i < neighbours.size(); i++)
     {
-        neighbourToDel.push_back(neighbour);
+        uint32_t neighbourId = this->storage.addVertex(neighbours[i]);
+        this->setMonitoredArc(newId, neighbourId, timestamps[i]);
     }
+}
 
-    for (string neighbour : neighbourToDel)
+void TemporalGraph::removeNode(string delNode)
+{
+    uint32_t delId = this->storage.names.find(delNode);
+    if (delId == NO_VERTEX || !this->storage.isAlive(delId))
+    {
+        return;
+    }
+    this->storage.removeVertex(delId);
+    if (this->monitor)
     {
-        this->graph[neighbour].erase(delNode);
+        this->monitor->vertexRemoved(this->storage, delId);
     }
-    this->graph.erase(delNode);
 }
 
 void TemporalGraph::addEdge(Edge newEdge)
 {
-    string newStart = newEdge.start;
-    string newEnd = newEdge.end;
-    vector<int> timestamps = newEdge.timestamps;
+    uint32_t startId = this->storage.addVertex(newEdge.start);
+    uint32_t endId = this->storage.addVertex(newEdge.end);
+    this->setMonitoredArc(startId, endId, newEdge.timestamps);
+}
 
-    if (this->setOfNodes.find(newStart) == this->setOfNodes.end())
+void TemporalGraph::removeEdge(Edge edgeToDel)
+{
+    uint32_t startId = this->storage.names.find(edgeToDel.start);
+    uint32_t endId = this->storage.names.find(edgeToDel.end);
+    if (startId == NO_VERTEX || endId == NO_VERTEX)
     {
-        this->addNode(newStart, {newEnd}, {timestamps});
+        return;
     }
-    else if (this->setOfNodes.find(newEnd) == this->setOfNodes.end())
+    vector<int> oldTimes = this->monitor ? arcTimes(this->storage, startId, endId) : vector<int>();
+    this->storage.removeArc(startId, endId);
+    if (this->monitor)
     {
-        this->addNode(newEnd, {newStart}, {timestamps});
+        this->monitor->arcChanged(this->storage, startId, endId, oldTimes);
     }
-    else
+}
+
+bool TemporalGraph::existEdge(string start, string end) const
+{
+    uint32_t startId = this->storage.names.find(start);
+    uint32_t endId = this->storage.names.find(end);
+    if (startId == NO_VERTEX || endId == NO_VERTEX)
     {
-        this->graph[newStart][newEnd] = timestamps;
-        this->graph[newEnd][newStart] = timestamps;
+        return false;
     }
+    return this->storage.findArc(startId, endId) != NO_ARC;
 }
 
-void TemporalGraph::removeEdge(Edge edgeToDel)
+unordered_map<string, int> TemporalGraph::earliestTime(string source, JourneyMode mode) const
 {
-    string startToDel = edgeToDel.start;
-    string endToDel = edgeToDel.end;
-    this->graph[startToDel].erase(endToDel);
-    this->graph[endToDel].erase(startToDel);
+    return this->earliestTime(source, numeric_limits<int>::min(), numeric_limits<int>::max(), mode);
 }
 
-bool TemporalGraph::existEdge(string start, string end)
+unordered_map<string, int> TemporalGraph::earliestTime(string source, int timeStart, int timeEnd, JourneyMode mode) const
 {
-    if (this->graph[start].find(end) == this->graph[start].end())
+    unordered_map<string, int> namedMap = this->namedTimes(this->earliestTime(source, timeStart, timeEnd, threadWorkspace(), mode));
+    namedMap[source] = numeric_limits<int>::min();
+    return namedMap;
+}
+
+unordered_map<string, unordered_map<string, int>> TemporalGraph::earliestTimeBatch(vector<string> sources, JourneyMode mode, size_t width) const
+{
+    vector<uint32_t> sourceIds;
+    for (const string &source : sources)
     {
-        return false;
+        uint32_t sourceId = this->storage.names.find(source);
+        if (sourceId != NO_VERTEX)
+        {
+            sourceIds.push_back(sourceId);
+        }
+    }
+
+    vector<int> matrix;
+    earliestArrivalBatch(makeContactView(this->storage), sourceIds, mode, width, matrix);
+
+    unordered_map<string, unordered_map<string, int>> eaMaps;
+    uint32_t n = this->storage.vertexCount();
+    for (size_t i = 0; i < sourceIds.size(); i++)
+    {
+        vector<int> row(matrix.begin() + i * n, matrix.begin() + (i + 1) * n);
+        eaMaps[this->storage.names.name(sourceIds[i])] = this->namedTimes(row);
+    }
+    // le sorgenti sconosciute non raggiungono nessuno, come in earliestTime
+    for (const string &source : sources)
+    {
+        if (eaMaps.find(source) == eaMaps.end())
+        {
+            eaMaps[source] = this->earliestTime(source, mode);
+        }
     }
-    return true;
+    return eaMaps;
+}
+
+void TemporalGraph::earliestTimeMatrix(vector<int> &matrix, ThreadPool &pool, JourneyMode mode) const
+{
+    ::earliestArrivalMatrix(makeContactView(this->storage), pool, mode, matrix);
+}
+
+void TemporalGraph::latestDepartureMatrix(vector<int> &matrix, ThreadPool &pool, JourneyMode mode) const
+{
+    ::latestDepartureMatrix(makeContactView(this->storage), pool, mode, matrix);
+}
+
+void TemporalGraph::reachabilityMatrix(vector<uint64_t> &bits, ThreadPool &pool, JourneyMode mode) const
+{
+    ::reachabilityMatrix(makeContactView(this->storage), pool, mode, bits);
+}
+
+TemporalTree TemporalGraph::earliestTimeTree(string source, JourneyMode mode) const
+{
+    return this->earliestTimeTree(source, numeric_limits<int>::min(), numeric_limits<int>::max(), mode);
 }
 
-unordered_map<string, int> TemporalGraph::earliestTime(string source)
+TemporalTree TemporalGraph::earliestTimeTree(string source, int timeStart, int timeEnd, JourneyMode mode) const
 {
-    unordered_map<string, int> eaMap;
-    vector<Edge> stream = this->edgeStream(source, false);
+    QueryWorkspace &workspace = threadWorkspace();
+    this->earliestTimeTree(source, timeStart, timeEnd, workspace, mode);
+    return this->workspaceTree(source, workspace);
+}
+
+unordered_map<string, int> TemporalGraph::latestDeparture(string source, JourneyMode mode) const
+{
+    return this->latestDeparture(source, numeric_limits<int>::min(), numeric_limits<int>::max(), mode);
+}
 
-    for (string node : this->setOfNodes)
+unordered_map<string, int> TemporalGraph::latestDeparture(string source, int timeStart, int timeEnd, JourneyMode mode) const
+{
+    unordered_map<string, int> namedMap = this->namedTimes(this->latestDeparture(source, timeStart, timeEnd, threadWorkspace(), mode));
+    namedMap[source] = numeric_limits<int>::max();
+    return namedMap;
+}
+
+TemporalTree TemporalGraph::latestDepartureTree(string destination, JourneyMode mode) const
+{
+    return this->latestDepartureTree(destination, numeric_limits<int>::min(), numeric_limits<int>::max(), mode);
+}
+
+TemporalTree TemporalGraph::latestDepartureTree(string destination, int timeStart, int timeEnd, JourneyMode mode) const
+{
+    QueryWorkspace &workspace = threadWorkspace();
+    this->latestDepartureTree(destination, timeStart, timeEnd, workspace, mode);
+    return this->workspaceTree(destination, workspace);
+}
+
+const pmr::vector<uint32_t> &TemporalGraph::edgeStream(const string &source, bool reverse, QueryWorkspace &workspace) const
+{
+    const TemporalStorage &storage = this->storage;
+    workspace.reset();
+    uint32_t sourceId = storage.names.find(source);
+    if (sourceId == NO_VERTEX)
     {
-        eaMap[node] = numeric_limits<int>::max();
+        return workspace.stream;
     }
 
-    eaMap[source] = numeric_limits<int>::min();
-
-    for (int i = 0; i < 2; i++)
+    // il flusso globale e' gia' ordinato: filtro solo i contatti che partono
+    // da vertici raggiungibili (staticamente) da source. Nei grafi non orientati ogni
+    // contatto compare una sola volta e vale in entrambe le direzioni
+    TEMPORAL_COUNT(queries, 1);
+    pmr::vector<uint8_t> &reached = workspace.reached;
+    pmr::vector<uint32_t> &stack = workspace.stack;
     {
-        for (const Edge edge : stream)
+        TEMPORAL_PHASE("edgeStream.reach");
+        reached.assign(storage.vertexCount(), false);
+        stack.push_back(sourceId);
+        reached[sourceId] = true;
+        while (stack.size() != 0)
         {
-            string start = edge.start;
-            string end = edge.end;
-            int timestamp = edge.timestamps[0];
+            uint32_t current = stack.back();
+            stack.pop_back();
+            storage.forEachNeighbour(current, [&reached, &stack](uint32_t neighbour, uint32_t)
+                                     {
+                                         if (!reached[neighbour])
+                                         {
+                                             reached[neighbour] = true;
+                                             stack.push_back(neighbour);
+                                         } });
+        }
+    }
 
-            if (timestamp >= eaMap[start])
-            {
-                if (timestamp < eaMap[end])
-                {
-                    eaMap[end] = timestamp;
-                }
-            }
+    TEMPORAL_PHASE("edgeStream.filter");
+    TEMPORAL_COUNT(contactsScanned, storage.contacts.size());
+    for (size_t i = 0; i < storage.contacts.size(); i++)
+    {
+        size_t index = reverse ? storage.contacts.size() - 1 - i : i;
+        if (reached[storage.contacts[index].from])
+        {
+            workspace.stream.push_back(index);
         }
     }
+    return workspace.stream;
+}
 
-    return eaMap;
+const pmr::vector<int> &TemporalGraph::earliestTime(const string &source, QueryWorkspace &workspace, JourneyMode mode) const
+{
+    return this->earliestTime(source, numeric_limits<int>::min(), numeric_limits<int>::max(), workspace, mode);
+}
+
+const pmr::vector<int> &TemporalGraph::earliestTime(const string &source, int timeStart, int timeEnd,
+                                                    QueryWorkspace &workspace, JourneyMode mode) const
+{
+    workspace.reset();
+    ContactView window = timeWindow(makeContactView(this->storage), timeStart, timeEnd);
+    earliestArrivalScan(window, this->storage.names.find(source), mode, workspace.times, nullptr, workspace.scratch);
+    return workspace.times;
 }
 
-TemporalTree TemporalGraph::earliestTimeTree(string source)
+const pmr::vector<int> &TemporalGraph::latestDeparture(const string &destination, QueryWorkspace &workspace,
+                                                       JourneyMode mode) const
 {
-    unordered_map<string, int> eaMap;
-    vector<Edge> stream = this->edgeStream(source, false);
-    TemporalTree eaTree(source);
+    return this->latestDeparture(destination, numeric_limits<int>::min(), numeric_limits<int>::max(), workspace, mode);
+}
+
+const pmr::vector<int> &TemporalGraph::latestDeparture(const string &destination, int timeStart, int timeEnd,
+                                                       QueryWorkspace &workspace, JourneyMode mode) const
+{
+    workspace.reset();
+    ContactView window = timeWindow(makeContactView(this->storage), timeStart, timeEnd);
+    latestDepartureScan(window, this->storage.names.find(destination), mode, workspace.times, nullptr, workspace.scratch);
+    return workspace.times;
+}
 
-    for (string node : this->setOfNodes)
+// Padre di ogni vertice dai contatti padre della scansione, come in parentTree
+static const pmr::vector<uint32_t> &workspaceParents(const TemporalStorage &storage, QueryWorkspace &workspace, bool reverse)
+{
+    TEMPORAL_PHASE("parentTree");
+    ContactView view = makeContactView(storage);
+    workspace.parent.assign(workspace.parentContact.size(), NO_VERTEX);
+    for (uint32_t node = 0; node < workspace.parentContact.size(); node++)
     {
-        eaMap[node] = numeric_limits<int>::max();
+        if (workspace.parentContact[node] != NO_CONTACT)
+        {
+            workspace.parent[node] = contactHead(view, storage.contacts[workspace.parentContact[node]], node, reverse);
+            TEMPORAL_COUNT(treeUpdates, 1);
+        }
     }
+    return workspace.parent;
+}
 
-    eaMap[source] = numeric_limits<int>::min();
+const pmr::vector<uint32_t> &TemporalGraph::earliestTimeTree(const string &source, QueryWorkspace &workspace,
+                                                             JourneyMode mode) const
+{
+    return this->earliestTimeTree(source, numeric_limits<int>::min(), numeric_limits<int>::max(), workspace, mode);
+}
+
+const pmr::vector<uint32_t> &TemporalGraph::earliestTimeTree(const string &source, int timeStart, int timeEnd,
+                                                             QueryWorkspace &workspace, JourneyMode mode) const
+{
+    workspace.reset();
+    ContactView window = timeWindow(makeContactView(this->storage), timeStart, timeEnd);
+    earliestArrivalScan(window, this->storage.names.find(source), mode, workspace.times, &workspace.parentContact,
+                        workspace.scratch);
+    return workspaceParents(this->storage, workspace, false);
+}
 
-    for (int i = 0; i < 2; i++)
+const pmr::vector<uint32_t> &TemporalGraph::latestDepartureTree(const string &destination, QueryWorkspace &workspace,
+                                                                JourneyMode mode) const
+{
+    return this->latestDepartureTree(destination, numeric_limits<int>::min(), numeric_limits<int>::max(), workspace, mode);
+}
+
+const pmr::vector<uint32_t> &TemporalGraph::latestDepartureTree(const string &destination, int timeStart, int timeEnd,
+                                                                QueryWorkspace &workspace, JourneyMode mode) const
+{
+    workspace.reset();
+    ContactView window = timeWindow(makeContactView(this->storage), timeStart, timeEnd);
+    latestDepartureScan(window, this->storage.names.find(destination), mode, workspace.times, &workspace.parentContact,
+                        workspace.scratch);
+    return workspaceParents(this->storage, workspace, true);
+}
+
+unordered_map<string, int64_t> TemporalGraph::fastestTime(string source, JourneyMode mode) const
+{
+    vector<int64_t> durations;
+    fastestJourneyScan(makeContactView(this->storage), this->storage.names.find(source), mode, durations, nullptr);
+
+    unordered_map<string, int64_t> namedMap = namedTimesOf(this->storage, durations);
+    namedMap[source] = 0;
+    return namedMap;
+}
+
+unordered_map<string, int> TemporalGraph::shortestHops(string source, JourneyMode mode) const
+{
+    vector<int> hops;
+    shortestJourneyScan(makeContactView(this->storage), this->storage.names.find(source), mode, hops, nullptr);
+
+    unordered_map<string, int> namedMap = this->namedTimes(hops);
+    namedMap[source] = 0;
+    return namedMap;
+}
+
+// Nei viaggi piu' veloci e piu' corti il prefisso di un viaggio ottimo non e' sempre ottimo
+// per il vertice intermedio: l'albero registra per ogni vertice l'ultimo contatto del suo
+// viaggio ottimo.
+TemporalTree TemporalGraph::fastestTimeTree(string source, JourneyMode mode) const
+{
+    vector<int64_t> durations;
+    vector<uint32_t> parentContact;
+    fastestJourneyScan(makeContactView(this->storage), this->storage.names.find(source), mode, durations, &parentContact);
+
+    return this->parentTree(source, move(parentContact), false);
+}
+
+TemporalTree TemporalGraph::shortestHopsTree(string source, JourneyMode mode) const
+{
+    vector<int> hops;
+    vector<uint32_t> parentContact;
+    shortestJourneyScan(makeContactView(this->storage), this->storage.names.find(source), mode, hops, &parentContact);
+
+    return this->parentTree(source, move(parentContact), false);
+}
+
+vector<uint32_t> TemporalGraph::aliveIds(const vector<string> &names) const
+{
+    vector<uint32_t> ids;
+    if (names.empty())
     {
-        for (const Edge edge : stream)
+        for (uint32_t u = 0; u < this->storage.vertexCount(); u++)
         {
-            string start = edge.start;
-            string end = edge.end;
-            int timestamp = edge.timestamps[0];
-
-            if (timestamp >= eaMap[start])
+            if (this->storage.isAlive(u))
             {
-                if (timestamp < eaMap[end])
-                {
-                    eaMap[end] = timestamp;
-                    eaTree.addEdge({start, end, {timestamp}});
-                }
+                ids.push_back(u);
             }
         }
     }
+    for (const string &name : names)
+    {
+        uint32_t id = this->storage.names.find(name);
+        if (this->storage.isAlive(id))
+        {
+            ids.push_back(id);
+        }
+    }
+    return ids;
+}
 
-    return eaTree;
+TemporalSpanner TemporalGraph::temporalSpanner(ThreadPool &pool, JourneyMode mode, vector<string> roots) const
+{
+    TemporalSpanner spanner;
+    buildTemporalSpanner(makeContactView(this->storage), this->aliveIds(roots), pool, mode, spanner);
+    return spanner;
 }
 
-unordered_map<string, int> TemporalGraph::latestDeparture(string source)
+TemporalGraph TemporalGraph::spannerGraph(const TemporalSpanner &spanner) const
 {
-    unordered_map<string, int> ldMap;
-    vector<Edge> stream = this->edgeStream(source, true);
+    return TemporalGraph(spannerStorage(this->storage, spanner));
+}
 
-    for (string node : this->setOfNodes)
+TemporalSpanner TemporalGraph::blackoutSpanner(int length, ThreadPool &pool, JourneyMode mode, vector<string> roots) const
+{
+    TemporalSpanner spanner;
+    buildBlackoutSpanner(this->storage, length, this->aliveIds(roots), pool, mode, spanner);
+    return spanner;
+}
+
+int TemporalGraph::earliestArrival(const string &source, const string &target, int departure, JourneyMode mode) const
+{
+    return pointToPointEarliestArrival(this->storage, this->storage.names.find(source), this->storage.names.find(target),
+                                       departure, numeric_limits<int>::max(), mode, threadWorkspace().pointToPoint);
+}
+
+ReachabilityIndex TemporalGraph::reachabilityIndex(ThreadPool &pool, JourneyMode mode, ReachabilityIndexOptions options) const
+{
+    if (options.sources.empty())
     {
-        ldMap[node] = numeric_limits<int>::min();
+        options.sources = this->aliveIds({});
     }
+    ReachabilityIndex index;
+    buildReachabilityIndex(makeContactView(this->storage), pool, mode, options, index);
+    index.graph = graphFingerprint(this->storage);
+    return index;
+}
 
-    ldMap[source] = numeric_limits<int>::max();
+int TemporalGraph::earliestArrival(const ReachabilityIndex &index, const string &source, const string &target,
+                                   int departure) const
+{
+    if (index.graph != graphFingerprint(this->storage))
+    {
+        throw invalid_argument("l'indice di raggiungibilita' non e' stato costruito su questo grafo");
+    }
+    uint32_t sourceId = this->storage.names.find(source);
+    uint32_t targetId = this->storage.names.find(target);
+    if (sourceId == NO_VERTEX || targetId == NO_VERTEX)
+    {
+        return numeric_limits<int>::max();
+    }
+    if (index.covers(sourceId, targetId))
+    {
+        return index.earliestArrival(sourceId, targetId, departure);
+    }
+    if (sourceId == targetId)
+    {
+        return departure;
+    }
+    return pointToPointEarliestArrival(this->storage, sourceId, targetId, max(departure, index.timeStart), index.timeEnd,
+                                       index.mode, threadWorkspace().pointToPoint);
+}
+
+bool TemporalGraph::temporallyConnected(ThreadPool &pool, JourneyMode mode, ConnectivityWitness *witness) const
+{
+    return ::temporallyConnected(makeContactView(this->storage), this->aliveIds({}), pool, mode, witness);
+}
 
-    for (int i = 0; i < 2; i++) // va fatto 2 volte poichè gli archi sono tutti duplicati e se non lo facessi non si ha un'ordine di visita prestabilito perdo informazioni
+bool TemporalGraph::verifyBlackoutSpanner(const TemporalGraph &subgraph, int length, ThreadPool &pool, JourneyMode mode,
+                                          BlackoutWitness *witness) const
+{
+    const TemporalStorage &sub = subgraph.storage;
+    if (sub.directed != this->storage.directed)
     {
-        for (const Edge edge : stream)
-        {
-            string start = edge.start;
-            string end = edge.end;
-            int timestamp = edge.timestamps[0];
+        throw invalid_argument("il sottografo ha un orientamento diverso dal grafo");
+    }
+    if (sub.names.names == this->storage.names.names)
+    {
+        return ::verifyBlackoutSpanner(this->storage, sub, length, this->aliveIds({}), pool, mode, witness);
+    }
 
-            if (timestamp <= ldMap[end])
-            {
-                if (timestamp >= ldMap[start])
-                {
-                    ldMap[start] = timestamp;
-                }
-            }
+    // stessi vertici con id diversi (per esempio archi inseriti in un altro ordine)
+    vector<uint32_t> ids(sub.vertexCount());
+    for (uint32_t v = 0; v < sub.vertexCount(); v++)
+    {
+        ids[v] = this->storage.names.find(sub.names.name(v));
+        if (ids[v] == NO_VERTEX && sub.isAlive(v))
+        {
+            throw invalid_argument("vertice del sottografo assente nel grafo: " + sub.names.name(v));
         }
     }
+    vector<Contact> contacts;
+    contacts.reserve(sub.contacts.size());
+    for (const Contact &contact : sub.contacts)
+    {
+        contacts.push_back({ids[contact.from], ids[contact.to], contact.time});
+    }
+    TemporalStorage mapped(this->storage.directed);
+    mapped.names = this->storage.names;
+    mapped.build(move(contacts));
+    mapped.alive = this->storage.alive;
+    return ::verifyBlackoutSpanner(this->storage, mapped, length, this->aliveIds({}), pool, mode, witness);
+}
 
-    return ldMap;
+void TemporalGraph::monitorSources(vector<string> sources, JourneyMode mode)
+{
+    this->monitor.emplace(this->storage, this->aliveIds(sources), mode);
 }
 
-TemporalTree TemporalGraph::latestDepartureTree(string destination)
+// l'albero di source e' mantenuto e copre tutti i vertici dello storage (non lo copre se lo
+// storage e' stato modificato direttamente, senza passare dal grafo)
+bool TemporalGraph::monitorCovers(uint32_t source) const
 {
-    unordered_map<string, int> ldMap;
-    vector<Edge> stream = this->edgeStream(destination, true);
-    TemporalTree ldTree(destination);
+    if (!this->monitor || this->monitor->treeOf(source) == this->monitor->trees.size())
+    {
+        return false;
+    }
+    return this->monitor->trees[this->monitor->treeOf(source)].ea.size() == this->storage.vertexCount();
+}
 
-    for (string node : this->setOfNodes)
+unordered_map<string, int> TemporalGraph::monitoredEarliestTime(string source) const
+{
+    uint32_t sourceId = this->storage.names.find(source);
+    if (!this->monitorCovers(sourceId))
     {
-        ldMap[node] = numeric_limits<int>::min();
+        return this->earliestTime(source, this->monitor ? this->monitor->mode : JourneyMode::NonStrict);
     }
+    return this->namedTimes(this->monitor->trees[this->monitor->treeOf(sourceId)].ea);
+}
 
-    ldMap[destination] = numeric_limits<int>::max();
+TemporalTree TemporalGraph::monitoredEarliestTimeTree(string source) const
+{
+    uint32_t sourceId = this->storage.names.find(source);
+    if (!this->monitorCovers(sourceId))
+    {
+        return this->earliestTimeTree(source, this->monitor ? this->monitor->mode : JourneyMode::NonStrict);
+    }
+    const DynamicTree &dynamicTree = this->monitor->trees[this->monitor->treeOf(sourceId)];
 
-    for (int i = 0; i < 2; i++) // va fatto 2 volte poichè gli archi sono tutti duplicati e se non lo facessi non si ha un'ordine di visita prestabilito perdo informazioni
+    TemporalTree tree(this->storage.names, source, this->storage.vertexCount());
+    for (uint32_t node = 0; node < this->storage.vertexCount(); node++)
     {
-        for (const Edge edge : stream)
+        if (dynamicTree.parent[node] != NO_VERTEX)
         {
-            string start = edge.start;
-            string end = edge.end;
-            int timestamp = edge.timestamps[0];
-
-            if (timestamp <= ldMap[end])
-            {
-                if (timestamp >= ldMap[start])
-                {
-                    ldMap[start] = timestamp;
-                    ldTree.addEdge({end, start, {timestamp}});
-                }
-            }
+            tree.setParent(node, dynamicTree.parent[node], dynamicTree.parentTime[node], NO_CONTACT);
         }
     }
+    tree.copyNames(this->storage.names);
+    return tree;
+}
 
-    return ldTree;
-}
\ No newline at end of file
+DynamicStats TemporalGraph::monitorStats() const
+{
+    return this->monitor ? this->monitor->stats : DynamicStats();
+}
+
+unordered_map<string, vector<array<int, 2>>> TemporalGraph::earliestTimeProfile(string source, JourneyMode mode) const
+{
+    TemporalProfile profile;
+    earliestArrivalProfile(makeContactView(this->storage), this->storage.names.find(source), mode, profile);
+    return this->namedProfile(profile);
+}
+
+unordered_map<string, vector<array<int, 2>>> TemporalGraph::latestDepartureProfile(string destination, JourneyMode mode) const
+{
+    TemporalProfile profile;
+    ::latestDepartureProfile(makeContactView(this->storage), this->storage.names.find(destination), mode, profile);
+    return this->namedProfile(profile);
+}
@@ -5,13 +5,34 @@
 #include <vector>
 #include <unordered_map>
 #include <string>
-#include <set>
 #include <utility>
 #include <limits>
 #include <algorithm>
+#include <array>
+#include <optional>
+#include <memory_resource>
+
+#include "temporalStorage.h"
+#include "temporalScan.h"
+#include "multiSourceScan.h"
+#include "temporalMatrix.h"
+#include "temporalJourneys.h"
+#include "temporalProfiles.h"
+#include "temporalLoader.h"
+#include "temporalGraphView.h"
+#include "temporalSpanner.h"
+#include "blackoutSpanner.h"
+#include "dynamicEarliestArrival.h"
+#include "temporalStream.h"
+#include "temporalConnectivity.h"
+#include "reachabilityIndex.h"
+#include "pointToPoint.h"
+#include "queryStats.h"
 
 using namespace std;
 
+class QueryWorkspace;
+
 struct Edge
 {
     string start;
@@ -22,48 +43,196 @@ struct Edge
     Edge(string start, string end);
 };
 
+// Albero temporale in array piatti indicizzati per id di vertice: per ogni vertice il padre,
+// il tempo e l'indice nel flusso del contatto padre (NO_VERTEX / NO_CONTACT per la radice e
+// per i vertici fuori dall'albero), con gli id del grafo da cui proviene. L'albero conserva
+// una copia dei nomi dei propri vertici, quindi resta valido anche dopo la distruzione o lo
+// spostamento del grafo. I figli non vengono memorizzati durante la costruzione: si
+// ricavano in un solo passaggio quando servono per la visita o la stampa.
 class TemporalTree
 {
 
 public:
-    set<string> setOfNodes;
-    unordered_map<string, unordered_map<string, vector<int>>> tree;
-    unordered_map<string, string> fatherMap;
     string root;
-
-    TemporalTree(string root);
-    TemporalTree(vector<Edge> edges);
-
-    void addEdge(Edge newEdge);
+    uint32_t rootId;
+
+    vector<uint32_t> parent;
+    vector<int> time;
+    vector<uint32_t> contact;
+
+    // nomi della radice e dei vertici raggiunti (vuoti per gli altri id) e loro id
+    vector<string> names;
+    unordered_map<string, uint32_t> ids;
+
+    TemporalTree(const NameTable &names, string root, uint32_t vertexCount);
+
+    // copia da graphNames i nomi della radice e dei vertici con un padre: va chiamata a
+    // costruzione finita, prima di restituire l'albero
+    void copyNames(const NameTable &graphNames);
+    // id del vertice nell'albero, NO_VERTEX se il nome non e' tra quelli copiati
+    uint32_t find(const string &node) const;
+
+    bool contains(uint32_t node) const;
+    bool contains(const string &node) const;
+    size_t size() const;
+    void setParent(uint32_t node, uint32_t father, int time, uint32_t contact);
+
+    // chiama visit(figlio) per ogni figlio di node, in ordine di id
+    template <typename Visit>
+    void forEachChild(uint32_t node, Visit visit)
+    {
+        this->indexChildren();
+        for (uint32_t i = this->childOffsets[node]; i < this->childOffsets[node + 1]; i++)
+        {
+            // l'indice non viene ricostruito dopo pruneSubtrees: i figli staccati si scartano qui
+            if (this->parent[this->children[i]] == node)
+            {
+                visit(this->children[i]);
+            }
+        }
+    }
+
+    // Stacca dall'albero i sottoalberi di tutte le radici indicate e restituisce i vertici
+    // rimossi. La visita e' iterativa e lineare nei sottoalberi rimossi: l'indice dei figli
+    // resta valido, perche' i vertici staccati hanno padre NO_VERTEX e vengono saltati.
+    vector<uint32_t> pruneSubtrees(const vector<uint32_t> &roots);
     void removeNode(string nodeToDelete);
 
-    void printTreeHelper(const string &node, string prefix, bool isLast);
+    void printTreeHelper(uint32_t node, string prefix, bool isLast);
     void printTree();
+
+private:
+    // figli in formato CSR, ricostruiti da indexChildren dopo ogni modifica
+    bool indexed = false;
+    vector<uint32_t> childOffsets;
+    vector<uint32_t> children;
+
+    void indexChildren();
 };
 
 class TemporalGraph
 {
 
 public:
-    set<string> setOfNodes;
-    unordered_map<string, unordered_map<string, vector<int>>> graph;
-
-    TemporalGraph(vector<Edge> edgesList);
-
-    void printGraph();
+    TemporalStorage storage;
+    // alberi EA delle sorgenti monitorate, aggiornati da addNode/removeNode/addEdge/removeEdge
+    optional<DynamicEarliestArrival> monitor;
+
+    // directed: ogni Edge e' un arco orientato da start a end; altrimenti vale nei due versi
+    TemporalGraph(vector<Edge> edgesList, bool directed = false);
+    // adotta uno storage gia' costruito, ad esempio da loadEdgeList o readSnapshot
+    explicit TemporalGraph(TemporalStorage storage);
+
+    vector<string> nodes() const;
+    unordered_map<string, int> namedTimes(const vector<int> &times) const;
+    unordered_map<string, int> namedTimes(const pmr::vector<int> &times) const;
+    // id dei vertici vivi tra quelli indicati; tutti i vertici vivi se names e' vuoto
+    vector<uint32_t> aliveIds(const vector<string> &names) const;
+    TemporalTree parentTree(string root, vector<uint32_t> parentContact, bool reverse) const;
+    TemporalTree workspaceTree(string root, const QueryWorkspace &workspace) const;
+    unordered_map<string, vector<array<int, 2>>> namedProfile(const TemporalProfile &profile) const;
+
+    void printGraph() const;
+    // setArc che aggiorna anche gli alberi monitorati
+    void setMonitoredArc(uint32_t start, uint32_t end, const vector<int> &timestamps);
     void addNode(string newNode, vector<string> neighbours, vector<vector<int>> timestamps);
     void removeNode(string delNode);
     void addEdge(Edge newEdge);
     void removeEdge(Edge edgeToDel);
-    bool existEdge(string start, string end);
-
-    vector<Edge> edgeStream(string source, bool reverse);
-
-    unordered_map<string, int> earliestTime(string source);
-    unordered_map<string, int> latestDeparture(string source);
-
-    TemporalTree earliestTimeTree(string source);
-    TemporalTree latestDepartureTree(string destination);
+    bool existEdge(string start, string end) const;
+
+    vector<Edge> edgeStream(string source, bool reverse) const;
+
+    unordered_map<string, int> earliestTime(string source, JourneyMode mode = JourneyMode::NonStrict) const;
+    unordered_map<string, int> latestDeparture(string source, JourneyMode mode = JourneyMode::NonStrict) const;
+
+    // varianti ristrette ai viaggi che usano solo contatti con tempo in [timeStart, timeEnd]
+    unordered_map<string, int> earliestTime(string source, int timeStart, int timeEnd, JourneyMode mode = JourneyMode::NonStrict) const;
+    unordered_map<string, int> latestDeparture(string source, int timeStart, int timeEnd, JourneyMode mode = JourneyMode::NonStrict) const;
+
+    unordered_map<string, unordered_map<string, int>> earliestTimeBatch(vector<string> sources,
+                                                                        JourneyMode mode = JourneyMode::NonStrict,
+                                                                        size_t width = 32) const;
+
+    void earliestTimeMatrix(vector<int> &matrix, ThreadPool &pool, JourneyMode mode = JourneyMode::NonStrict) const;
+    void latestDepartureMatrix(vector<int> &matrix, ThreadPool &pool, JourneyMode mode = JourneyMode::NonStrict) const;
+    void reachabilityMatrix(vector<uint64_t> &bits, ThreadPool &pool, JourneyMode mode = JourneyMode::NonStrict) const;
+
+    TemporalTree earliestTimeTree(string source, JourneyMode mode = JourneyMode::NonStrict) const;
+    TemporalTree latestDepartureTree(string destination, JourneyMode mode = JourneyMode::NonStrict) const;
+    TemporalTree earliestTimeTree(string source, int timeStart, int timeEnd, JourneyMode mode = JourneyMode::NonStrict) const;
+    TemporalTree latestDepartureTree(string destination, int timeStart, int timeEnd, JourneyMode mode = JourneyMode::NonStrict) const;
+
+    // Varianti che non allocano a regime: lo stato e il risultato, indicizzato per id di
+    // vertice, stanno in workspace (queryWorkspace.h) e valgono fino alla query successiva
+    // sulla stessa workspace. edgeStream restituisce gli indici dei contatti in storage.contacts,
+    // gli alberi restituiscono il padre di ogni vertice (con tempi in workspace.times e
+    // contatti padre in workspace.parentContact).
+    const pmr::vector<uint32_t> &edgeStream(const string &source, bool reverse, QueryWorkspace &workspace) const;
+    const pmr::vector<int> &earliestTime(const string &source, QueryWorkspace &workspace,
+                                         JourneyMode mode = JourneyMode::NonStrict) const;
+    const pmr::vector<int> &latestDeparture(const string &destination, QueryWorkspace &workspace,
+                                            JourneyMode mode = JourneyMode::NonStrict) const;
+    const pmr::vector<int> &earliestTime(const string &source, int timeStart, int timeEnd, QueryWorkspace &workspace,
+                                         JourneyMode mode = JourneyMode::NonStrict) const;
+    const pmr::vector<int> &latestDeparture(const string &destination, int timeStart, int timeEnd,
+                                            QueryWorkspace &workspace, JourneyMode mode = JourneyMode::NonStrict) const;
+    const pmr::vector<uint32_t> &earliestTimeTree(const string &source, QueryWorkspace &workspace,
+                                                  JourneyMode mode = JourneyMode::NonStrict) const;
+    const pmr::vector<uint32_t> &latestDepartureTree(const string &destination, QueryWorkspace &workspace,
+                                                     JourneyMode mode = JourneyMode::NonStrict) const;
+    const pmr::vector<uint32_t> &earliestTimeTree(const string &source, int timeStart, int timeEnd,
+                                                  QueryWorkspace &workspace, JourneyMode mode = JourneyMode::NonStrict) const;
+    const pmr::vector<uint32_t> &latestDepartureTree(const string &destination, int timeStart, int timeEnd,
+                                                     QueryWorkspace &workspace, JourneyMode mode = JourneyMode::NonStrict) const;
+
+    // la durata puo' superare INT_MAX (fino a 2^32 - 1): INT64_MAX se non raggiungibile
+    unordered_map<string, int64_t> fastestTime(string source, JourneyMode mode = JourneyMode::NonStrict) const;
+    unordered_map<string, int> shortestHops(string source, JourneyMode mode = JourneyMode::NonStrict) const;
+
+    TemporalTree fastestTimeTree(string source, JourneyMode mode = JourneyMode::NonStrict) const;
+    TemporalTree shortestHopsTree(string source, JourneyMode mode = JourneyMode::NonStrict) const;
+
+    // spanner dall'unione degli alberi EA/LD delle radici indicate (tutti i vertici se roots e' vuoto)
+    TemporalSpanner temporalSpanner(ThreadPool &pool, JourneyMode mode = JourneyMode::NonStrict, vector<string> roots = {}) const;
+    TemporalGraph spannerGraph(const TemporalSpanner &spanner) const;
+
+    // earliest arrival in target partendo da source non prima di departure (INT_MAX se
+    // irraggiungibile): si ferma appena target e' risolto, senza calcolare tutta la mappa
+    int earliestArrival(const string &source, const string &target, int departure,
+                        JourneyMode mode = JourneyMode::NonStrict) const;
+
+    // indice delle query punto a punto; options.sources contiene id (vuoto = tutti i vertici vivi)
+    ReachabilityIndex reachabilityIndex(ThreadPool &pool, JourneyMode mode = JourneyMode::NonStrict,
+                                        ReachabilityIndexOptions options = {}) const;
+    // earliest arrival in target partendo da source non prima di departure: dall'indice se
+    // copre la coppia, altrimenti con la query punto a punto nella finestra dell'indice;
+    // invalid_argument se l'indice e' stato costruito su un altro grafo o prima di una modifica
+    int earliestArrival(const ReachabilityIndex &index, const string &source, const string &target, int departure) const;
+
+    // ogni vertice vivo raggiunge tutti gli altri; altrimenti witness riceve una coppia mancante
+    bool temporallyConnected(ThreadPool &pool, JourneyMode mode = JourneyMode::NonStrict,
+                             ConnectivityWitness *witness = nullptr) const;
+
+    // spanner che conserva i tempi di arrivo dalle radici sotto ogni blackout di lunghezza length
+    TemporalSpanner blackoutSpanner(int length, ThreadPool &pool, JourneyMode mode = JourneyMode::NonStrict,
+                                    vector<string> roots = {}) const;
+    // verifica che subgraph conservi la connettivita' temporale da ogni vertice sotto ogni blackout;
+    // i vertici di subgraph sono riportati agli id del grafo per nome (invalid_argument se
+    // subgraph ha un vertice che il grafo non ha o un orientamento diverso)
+    bool verifyBlackoutSpanner(const TemporalGraph &subgraph, int length, ThreadPool &pool,
+                               JourneyMode mode = JourneyMode::NonStrict, BlackoutWitness *witness = nullptr) const;
+
+    // da qui in poi le modifiche del grafo aggiornano incrementalmente gli alberi EA di sources
+    void monitorSources(vector<string> sources, JourneyMode mode = JourneyMode::NonStrict);
+    // tempi e albero mantenuti per una sorgente monitorata; per le altre si ricalcolano
+    unordered_map<string, int> monitoredEarliestTime(string source) const;
+    TemporalTree monitoredEarliestTimeTree(string source) const;
+    bool monitorCovers(uint32_t source) const;
+    DynamicStats monitorStats() const;
+
+    unordered_map<string, vector<array<int, 2>>> earliestTimeProfile(string source, JourneyMode mode = JourneyMode::NonStrict) const;
+    unordered_map<string, vector<array<int, 2>>> latestDepartureProfile(string destination, JourneyMode mode = JourneyMode::NonStrict) const;
 };
 
 #endif
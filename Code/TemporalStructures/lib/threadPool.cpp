@@ -0,0 +1,179 @@
+#include "threadPool.h"
+
+#include <stdexcept>
+
+using namespace std;
+
+// pool di cui il thread corrente e' un worker, per riconoscere le chiamate annidate
+static thread_local const ThreadPool *currentPool = nullptr;
+
+ThreadPool::ThreadPool(unsigned threads)
+{
+    if (threads == 0)
+    {
+        threads = 1;
+    }
+    for (unsigned worker = 0; worker < threads; worker++)
+    {
+        this->ranges.push_back(make_unique<Range>());
+    }
+    for (unsigned worker = 0; worker < threads; worker++)
+    {
+        this->workers.emplace_back(&ThreadPool::workerLoop, this, worker);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        lock_guard<mutex> guard(this->lock);
+        this->stopping = true;
+    }
+    this->wake.notify_all();
+    for (thread &worker : this->workers)
+    {
+        worker.join();
+    }
+}
+
+unsigned ThreadPool::size() const
+{
+    return this->workers.size();
+}
+
+void ThreadPool::parallelFor(size_t count, const function<void(size_t, unsigned)> &task)
+{
+    if (currentPool == this)
+    {
+        throw logic_error("parallelFor chiamata da un task dello stesso pool");
+    }
+    if (count == 0)
+    {
+        return;
+    }
+
+    unsigned threads = this->size();
+    for (unsigned worker = 0; worker < threads; worker++)
+    {
+        Range &range = *this->ranges[worker];
+        lock_guard<mutex> guard(range.lock);
+        range.begin = count * worker / threads;
+        range.end = count * (worker + 1) / threads;
+    }
+
+    unique_lock<mutex> guard(this->lock);
+    this->task = &task;
+    this->error = nullptr;
+    this->failed = false;
+    this->running = threads;
+    this->generation++;
+    this->wake.notify_all();
+    this->done.wait(guard, [this]
+                    { return this->running == 0; });
+    this->task = nullptr;
+    if (this->error)
+    {
+        exception_ptr error = this->error;
+        this->error = nullptr;
+        rethrow_exception(error);
+    }
+}
+
+void ThreadPool::workerLoop(unsigned worker)
+{
+    currentPool = this;
+    size_t seenGeneration = 0;
+    while (true)
+    {
+        const function<void(size_t, unsigned)> *currentTask;
+        {
+            unique_lock<mutex> guard(this->lock);
+            this->wake.wait(guard, [this, seenGeneration]
+                            { return this->stopping || this->generation != seenGeneration; });
+            if (this->stopping)
+            {
+                return;
+            }
+            seenGeneration = this->generation;
+            currentTask = this->task;
+        }
+
+        size_t index;
+        while (!this->failed.load(memory_order_relaxed) && this->nextIndex(worker, index))
+        {
+            try
+            {
+                (*currentTask)(index, worker);
+            }
+            catch (...)
+            {
+                lock_guard<mutex> guard(this->lock);
+                if (!this->error)
+                {
+                    this->error = current_exception();
+                }
+                this->failed = true;
+            }
+        }
+
+        lock_guard<mutex> guard(this->lock);
+        if (--this->running == 0)
+        {
+            this->done.notify_all();
+        }
+    }
+}
+
+bool ThreadPool::nextIndex(unsigned worker, size_t &index)
+{
+    Range &own = *this->ranges[worker];
+    {
+        lock_guard<mutex> guard(own.lock);
+        if (own.begin < own.end)
+        {
+            index = own.begin++;
+            return true;
+        }
+    }
+
+    // fetta esaurita: rubo la meta' superiore della fetta piu' grande
+    while (true)
+    {
+        unsigned victim = worker;
+        size_t largest = 0;
+        for (unsigned other = 0; other < this->ranges.size(); other++)
+        {
+            Range &range = *this->ranges[other];
+            lock_guard<mutex> guard(range.lock);
+            if (range.end - range.begin > largest)
+            {
+                largest = range.end - range.begin;
+                victim = other;
+            }
+        }
+        if (largest == 0)
+        {
+            return false;
+        }
+
+        size_t stolenBegin;
+        size_t stolenEnd;
+        {
+            Range &range = *this->ranges[victim];
+            lock_guard<mutex> guard(range.lock);
+            if (range.begin >= range.end)
+            {
+                continue;
+            }
+            stolenEnd = range.end;
+            stolenBegin = range.begin + (range.end - range.begin) / 2;
+            range.end = stolenBegin;
+        }
+
+        index = stolenBegin;
+        lock_guard<mutex> guard(own.lock);
+        own.begin = stolenBegin + 1;
+        own.end = stolenEnd;
+        return true;
+    }
+}
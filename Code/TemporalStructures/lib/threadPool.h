@@ -0,0 +1,65 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+// Pool di thread persistente con work stealing.
+// parallelFor divide gli indici in una fetta contigua per worker; chi esaurisce la
+// propria fetta ruba la meta' superiore della fetta piu' grande rimasta a un altro worker.
+class ThreadPool
+{
+
+public:
+    ThreadPool(unsigned threads = thread::hardware_concurrency());
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    unsigned size() const;
+
+    // Esegue task(indice, worker) per ogni indice in [0, count) e ritorna quando sono
+    // stati eseguiti tutti. worker e' in [0, size()) e permette di usare buffer per-worker.
+    // Se un task lancia un'eccezione gli indici non ancora iniziati vengono saltati e la
+    // prima eccezione viene rilanciata qui, sul thread chiamante.
+    // Non e' rientrante: non va chiamata da un task dello stesso pool (logic_error) ne' da
+    // due thread contemporaneamente.
+    void parallelFor(size_t count, const function<void(size_t, unsigned)> &task);
+
+private:
+    struct Range
+    {
+        mutex lock;
+        size_t begin = 0;
+        size_t end = 0;
+    };
+
+    vector<thread> workers;
+    vector<unique_ptr<Range>> ranges;
+
+    mutex lock;
+    condition_variable wake;
+    condition_variable done;
+    const function<void(size_t, unsigned)> *task = nullptr;
+    size_t generation = 0;
+    unsigned running = 0;
+    bool stopping = false;
+    // prima eccezione dei task della parallelFor in corso
+    exception_ptr error;
+    atomic<bool> failed{false};
+
+    void workerLoop(unsigned worker);
+    bool nextIndex(unsigned worker, size_t &index);
+};
+
+#endif
@@ -0,0 +1,192 @@
+#include "windowAlgorithms.h"
+
+#include <algorithm>
+
+using namespace std;
+
+static void resetWindow(WindowResult &result, uint32_t vertexCount, uint32_t source, int sourceTime, int otherTime)
+{
+    result.log.clear();
+    result.below.clear();
+    result.top.resize(vertexCount);
+    for (uint32_t v = 0; v < vertexCount; v++)
+    {
+        result.top[v] = v;
+        result.log.push_back({0, v == source ? sourceTime : otherTime});
+        result.below.push_back(NO_CONTACT);
+    }
+}
+
+static void pushWindow(WindowResult &result, uint32_t vertex, array<int, 2> entry)
+{
+    TEMPORAL_COUNT(treeUpdates, 1);
+    result.below.push_back(result.top[vertex]);
+    result.top[vertex] = result.log.size();
+    result.log.push_back(entry);
+}
+
+// Trasforma le pile in CSR, dalla coppia piu' vecchia alla piu' recente
+static void flattenWindow(WindowResult &result)
+{
+    uint32_t n = result.top.size();
+    result.offsets.resize(n + 1);
+    result.offsets[0] = 0;
+    for (uint32_t v = 0; v < n; v++)
+    {
+        uint32_t size = 0;
+        for (uint32_t entry = result.top[v]; entry != NO_CONTACT; entry = result.below[entry])
+        {
+            size++;
+        }
+        result.offsets[v + 1] = result.offsets[v] + size;
+    }
+
+    result.entries.resize(result.offsets[n]);
+    for (uint32_t v = 0; v < n; v++)
+    {
+        uint32_t position = result.offsets[v + 1];
+        for (uint32_t entry = result.top[v]; entry != NO_CONTACT; entry = result.below[entry])
+        {
+            result.entries[--position] = result.log[entry];
+        }
+    }
+}
+
+// Chiama step(from, to, tempo) per ogni passo diretto del flusso, in avanti o all'indietro.
+// Gli algoritmi a finestra non ripropagano i gruppi di contatti simultanei, quindi il
+// risultato dipende dall'ordine dei passi: nei grafi non orientati ogni gruppo viene
+// percorso nell'ordine (from, to) che avrebbero i contatti materializzati nei due versi.
+template <typename Step>
+static void forEachStep(const ContactView &view, bool forward, pmr::vector<Contact> &group, Step step)
+{
+    size_t count = view.last - view.first;
+    TEMPORAL_COUNT(contactsScanned, count);
+    if (!view.undirected)
+    {
+        for (size_t k = 0; k < count; k++)
+        {
+            const Contact &contact = view.contacts[forward ? view.first + k : view.last - 1 - k];
+            step(contact.from, contact.to, contact.time);
+        }
+        return;
+    }
+
+    // gruppi percorsi dal primo all'ultimo in avanti, dall'ultimo al primo all'indietro
+    for (size_t done = 0; done < count;)
+    {
+        size_t groupFirst = forward ? view.first + done : view.last - 1 - done;
+        int time = view.contacts[groupFirst].time;
+        group.clear();
+        for (; done < count; done++)
+        {
+            const Contact &contact = view.contacts[forward ? view.first + done : view.last - 1 - done];
+            if (contact.time != time)
+            {
+                break;
+            }
+            group.push_back(contact);
+            if (contact.from != contact.to)
+            {
+                group.push_back({contact.to, contact.from, contact.time});
+            }
+        }
+
+        sort(group.begin(), group.end(), contactBefore);
+        if (!forward)
+        {
+            reverse(group.begin(), group.end());
+        }
+        for (const Contact &contact : group)
+        {
+            step(contact.from, contact.to, contact.time);
+        }
+    }
+}
+
+void windowAlgorithmEa(const ContactView &view, uint32_t source, WindowResult &result)
+{
+    TEMPORAL_PHASE("windowAlgorithmEa");
+    TEMPORAL_COUNT(queries, 1);
+    resetWindow(result, view.vertexCount, source, 0, numeric_limits<int>::max());
+
+    int level = 0;
+
+    auto step = [&](uint32_t from, uint32_t to, int timestamp)
+    {
+        if (from == source && timestamp > result.log[result.top[source]][1])
+        {
+            level += 1;
+            pushWindow(result, source, {level, timestamp});
+        }
+
+        auto [lvStart, eaStart] = result.log[result.top[from]];
+        auto [lvEnd, eaEnd] = result.log[result.top[to]];
+
+        if (lvStart > lvEnd && lvStart != 0 && eaStart <= timestamp)
+        {
+            pushWindow(result, to, {lvStart, timestamp});
+            TEMPORAL_COUNT(relaxations, 1);
+        }
+        else if (lvStart == lvEnd && lvStart != 0 && eaStart <= timestamp && eaEnd > timestamp)
+        {
+            result.log[result.top[to]] = {lvEnd, timestamp};
+            TEMPORAL_COUNT(relaxations, 1);
+        }
+    };
+
+    if (source != NO_VERTEX)
+    {
+        forEachStep(view, true, result.group, step);
+    }
+
+    flattenWindow(result);
+}
+
+void windowAlgorithmLd(const ContactView &view, uint32_t source, WindowResult &result)
+{
+    TEMPORAL_PHASE("windowAlgorithmLd");
+    TEMPORAL_COUNT(queries, 1);
+    resetWindow(result, view.vertexCount, source, numeric_limits<int>::max(), numeric_limits<int>::min());
+
+    int level = 0;
+
+    auto step = [&](uint32_t from, uint32_t to, int timestamp)
+    {
+        if (from == source && timestamp < result.log[result.top[source]][1])
+        {
+            level += 1;
+            pushWindow(result, source, {level, timestamp});
+        }
+
+        auto [lvStart, ldStart] = result.log[result.top[from]];
+        auto [lvEnd, ldEnd] = result.log[result.top[to]];
+
+        if (lvStart > lvEnd && lvStart != 0 && timestamp <= ldStart)
+        {
+            pushWindow(result, to, {lvStart, timestamp});
+            TEMPORAL_COUNT(relaxations, 1);
+        }
+        else if (lvStart == lvEnd && lvStart != 0 && ldStart <= timestamp && timestamp > ldEnd)
+        {
+            result.log[result.top[to]] = {lvEnd, timestamp};
+            TEMPORAL_COUNT(relaxations, 1);
+        }
+    };
+
+    if (source != NO_VERTEX)
+    {
+        forEachStep(view, false, result.group, step);
+    }
+
+    flattenWindow(result);
+}
+
+void windowAlgorithmEa(const TemporalGraph &g, const string &source, WindowResult &result)
+{
+    windowAlgorithmEa(makeContactView(g.storage), g.storage.names.find(source), result);
+}
+
+void windowAlgorithmLd(const TemporalGraph &g, const string &source, WindowResult &result)
+{
+    windowAlgorithmLd(makeContactView(g.storage), g.storage.names.find(source), result);
+}
@@ -0,0 +1,46 @@
+#ifndef WINDOWALGORITHMS_H
+#define WINDOWALGORITHMS_H
+
+#include <array>
+#include <cstdint>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+#include "temporalStructures.h"
+
+using namespace std;
+
+// Risultato degli algoritmi a finestra: per ogni vertice la sequenza di coppie
+// (livello, tempo), in formato CSR: le coppie del vertice v sono
+// entries[offsets[v] .. offsets[v + 1]). Tutti i buffer appartengono al chiamante e
+// vengono riusati tra una chiamata e l'altra, quindi a regime non si alloca nulla;
+// possono anche venire da un memory_resource, come in QueryWorkspace.
+struct WindowResult
+{
+    pmr::vector<uint32_t> offsets;
+    pmr::vector<array<int, 2>> entries;
+
+    // pile per vertice durante la scansione: coppia e indice dell'elemento sottostante
+    pmr::vector<array<int, 2>> log;
+    pmr::vector<uint32_t> below;
+    pmr::vector<uint32_t> top;
+
+    // passi del gruppo di contatti simultanei corrente (grafi non orientati)
+    pmr::vector<Contact> group;
+
+    explicit WindowResult(pmr::memory_resource *resource = pmr::get_default_resource())
+        : offsets(resource), entries(resource), log(resource), below(resource), top(resource), group(resource)
+    {
+    }
+};
+
+// Ogni contatto della sorgente con tempo successivo all'ultimo livello apre un nuovo
+// livello; i livelli si propagano lungo il flusso ordinato come in una query di profilo.
+void windowAlgorithmEa(const ContactView &view, uint32_t source, WindowResult &result);
+void windowAlgorithmLd(const ContactView &view, uint32_t source, WindowResult &result);
+
+void windowAlgorithmEa(const TemporalGraph &g, const string &source, WindowResult &result);
+void windowAlgorithmLd(const TemporalGraph &g, const string &source, WindowResult &result);
+
+#endif
@@ -1,109 +1,24 @@
-#include "../lib/temporalStructures.h"
-#include "array"
+#include "../lib/windowAlgorithms.h"
 
 using namespace std;
 
-void printMap(const unordered_map<string, vector<array<int, 2>>> &myMap)
+void printWindowResult(const TemporalGraph &g, const WindowResult &result)
 {
-    for (const auto &[key, vec] : myMap)
-    { // C++17 structured binding
-        cout << key << ": [";
-        for (size_t i = 0; i < vec.size(); ++i)
-        {
-            cout << "[" << vec[i][0] << ", " << vec[i][1] << "]";
-            if (i + 1 < vec.size())
-                cout << ", ";
-        }
-        cout << "]\n";
-    }
-}
-
-unordered_map<string, vector<array<int, 2>>> windowAlgorithmEa(string source, TemporalGraph g)
-{
-    vector<Edge> stream = g.edgeStream(source, false);
-    unordered_map<string, vector<array<int, 2>>> eaMap;
-
-    for (string node : g.setOfNodes)
-    {
-        if (node == source)
-        {
-            eaMap[node] = {{0, 0}};
-        }
-        else
-        {
-            eaMap[node] = {{0, numeric_limits<int>::max()}};
-        }
-    }
-
-    int level = 0;
-
-    for (const auto &[start, end, timestamp] : stream)
-    {
-        if (start == source && timestamp[0] > eaMap[source].back()[1])
-        {
-            level += 1;
-            eaMap[source].push_back(array<int, 2>{level, timestamp[0]});
-        }
-
-        auto [lvStart, eaStart] = eaMap[start].back();
-        auto [lvEnd, eaEnd] = eaMap[end].back();
-
-        if (lvStart > lvEnd && lvStart != 0 && eaStart <= timestamp[0])
-        {
-            eaMap[end].push_back({lvStart, timestamp[0]});
-        }
-        else if (lvStart == lvEnd && lvStart != 0 && eaStart <= timestamp[0] && eaEnd > timestamp[0])
-        {
-            eaMap[end].pop_back();
-            eaMap[end].push_back({lvEnd, timestamp[0]});
-        }
-    }
-
-    return eaMap;
-}
-
-unordered_map<string, vector<array<int, 2>>> windowAlgorithmLd(string source, TemporalGraph g)
-{
-    vector<Edge> stream = g.edgeStream(source, true);
-    unordered_map<string, vector<array<int, 2>>> ldMap;
-
-    for (string node : g.setOfNodes)
-    {
-        if (node == source)
-        {
-            ldMap[node] = {{0, numeric_limits<int>::max()}};
-        }
-        else
-        {
-            ldMap[node] = {{0, numeric_limits<int>::min()}};
-        }
-    }
-
-    int level = 0;
-
-    for (const auto &[start, end, timestamp] : stream)
+    for (uint32_t node = 0; node < g.storage.vertexCount(); node++)
     {
-        if (start == source && timestamp[0] < ldMap[source].back()[1])
-        {
-            level += 1;
-            ldMap[source].push_back(array<int, 2>{level, timestamp[0]});
-        }
-
-        auto [lvStart, ldStart] = ldMap[start].back();
-        auto [lvEnd, ldEnd] = ldMap[end].back();
-
-        if (lvStart > lvEnd && lvStart != 0 && timestamp[0] <= ldStart)
+        if (!g.storage.isAlive(node))
         {
-            ldMap[end].push_back({lvStart, timestamp[0]});
+            continue;
         }
-        else if (lvStart == lvEnd && lvStart != 0 && ldStart <= timestamp[0] && timestamp[0] > ldEnd)
+        cout << g.storage.names.name(node) << ": [";
+        for (uint32_t i = result.offsets[node]; i < result.offsets[node + 1]; ++i)
         {
-            ldMap[end].pop_back();
-            ldMap[end].push_back({lvEnd, timestamp[0]});
+            cout << "[" << result.entries[i][0] << ", " << result.entries[i][1] << "]";
+            if (i + 1 < result.offsets[node + 1])
+                cout << ", ";
         }
+        cout << "]\n";
     }
-
-    return ldMap;
 }
 
 int main()
@@ -140,19 +55,17 @@ int main()
         {"f", "t", {10}},
     });
 
-    unordered_map<string, vector<array<int, 2>>>
-        gMap = windowAlgorithmEa("D", g);
-
-    unordered_map<string, vector<array<int, 2>>>
-        tMap = windowAlgorithmEa("s", t);
+    // i buffer dei risultati vengono riusati da una chiamata all'altra
+    WindowResult eaResult;
+    WindowResult ldResult;
 
-    // printMap(tMap);
+    windowAlgorithmEa(g, "D", eaResult);
+    windowAlgorithmEa(t, "s", eaResult);
 
-    unordered_map<string, vector<array<int, 2>>>
-        ldGMap = windowAlgorithmLd("D", g);
+    // printWindowResult(t, eaResult);
 
-    unordered_map<string, vector<array<int, 2>>>
-        ldTMap = windowAlgorithmLd("s", t);
+    windowAlgorithmLd(g, "D", ldResult);
+    printWindowResult(g, ldResult);
 
-    printMap(ldGMap);
+    windowAlgorithmLd(t, "s", ldResult);
 }
\ No newline at end of file